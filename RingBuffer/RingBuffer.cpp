@@ -1,4 +1,6 @@
 #include "RingBuffer.h"
+#include "RingBufferMem.h"
+#include "RingBufferCopy.h"
 
 static ringbuffer_status ringbuffer_status_check(ringbuffer *rb)
 {
@@ -16,6 +18,31 @@ static ringbuffer_status ringbuffer_status_check(ringbuffer *rb)
     return RINGBUFFER_NOT_FULL_AND_NOT_EMPTY;
 }
 
+// 移动读写位置，越过末尾时翻转mirror位，length 不超过 buffer_size
+static inline void ringbuffer_advance_write(ringbuffer *rb, uint32_t length)
+{
+    uint32_t index = rb->write_index + length;
+
+    if (index >= rb->buffer_size)
+    {
+        index -= rb->buffer_size;
+        rb->write_mirror = ~rb->write_mirror;
+    }
+    rb->write_index = index;
+}
+
+static inline void ringbuffer_advance_read(ringbuffer *rb, uint32_t length)
+{
+    uint32_t index = rb->read_index + length;
+
+    if (index >= rb->buffer_size)
+    {
+        index -= rb->buffer_size;
+        rb->read_mirror = ~rb->read_mirror;
+    }
+    rb->read_index = index;
+}
+
 ringbuffer *ringbuffer_create(uint32_t length)
 {
     ringbuffer *rb = nullptr;
@@ -46,11 +73,44 @@ exit:
     return rb;
 }
 
+ringbuffer *ringbuffer_create_ex(uint32_t length, uint32_t flags, int numa_node)
+{
+    ringbuffer *rb = nullptr;
+    uint8_t *pool = nullptr;
+
+    assert(length > 0);
+
+    if (posix_memalign((void **)&rb, RINGBUFFER_CACHELINE_SIZE, sizeof(ringbuffer)) != 0)
+    {
+        rb = nullptr;
+        goto exit;
+    }
+
+    pool = ringbuffer_mem_alloc(&length, &flags, numa_node);
+    if (pool == nullptr)
+    {
+        free(rb);
+        rb = nullptr;
+        goto exit;
+    }
+
+    ringbuffer_init(rb, pool, length);
+    rb->flags = flags;
+
+exit:
+    return rb;
+}
+
+ringbuffer *ringbuffer_create_mirrored(uint32_t length)
+{
+    return ringbuffer_create_ex(length, RINGBUFFER_FLAG_MIRRORED, -1);
+}
+
 void ringbuffer_destroy(ringbuffer *rb)
 {
     assert(rb != nullptr);
 
-    free(rb->buffer);
+    ringbuffer_mem_free(rb->buffer, rb->buffer_size, rb->flags);
     free(rb);
 }
 
@@ -64,6 +124,7 @@ void ringbuffer_init(ringbuffer *rb, uint8_t *buffer, uint32_t length)
 
     rb->buffer = buffer;
     rb->buffer_size = ALIGN_DOWN(length, DEFAULT_ALIGN_SIZE);
+    rb->flags = 0;
 
 }
 
@@ -93,15 +154,22 @@ uint32_t ringbuffer_put(ringbuffer *rb, uint8_t *data, uint32_t length)
         length = available_len;
     }
 
+    if (rb->flags & RINGBUFFER_FLAG_MIRRORED)
+    {
+        ringbuffer_copy(&rb->buffer[rb->write_index], data, length);
+        ringbuffer_advance_write(rb, length);
+        return length;
+    }
+
     if (rb->buffer_size - rb->write_index > length)
     {
-        memcpy(&rb->buffer[rb->write_index], data, length);
+        ringbuffer_copy(&rb->buffer[rb->write_index], data, length);
         rb->write_index += length;
         return length;
     }
 
-    memcpy(&rb->buffer[rb->write_index], data, rb->buffer_size - rb->write_index);
-    memcpy(&rb->buffer[0], &data[rb->buffer_size - rb->write_index], length - (rb->buffer_size - rb->write_index));
+    ringbuffer_copy(&rb->buffer[rb->write_index], data, rb->buffer_size - rb->write_index);
+    ringbuffer_copy(&rb->buffer[0], &data[rb->buffer_size - rb->write_index], length - (rb->buffer_size - rb->write_index));
 
     rb->write_mirror = ~rb->write_mirror;
 
@@ -122,9 +190,22 @@ uint32_t ringbuffer_put_force(ringbuffer *rb, uint8_t *data, uint32_t length)
         length = rb->buffer_size;
     }
 
+    if (rb->flags & RINGBUFFER_FLAG_MIRRORED)
+    {
+        ringbuffer_copy(&rb->buffer[rb->write_index], data, length);
+        ringbuffer_advance_write(rb, length);
+
+        if (length > space_len)     //覆盖了旧数据，缓存区变满
+        {
+            rb->read_index = rb->write_index;
+            rb->read_mirror = ~rb->write_mirror;
+        }
+        return length;
+    }
+
     if (rb->buffer_size - rb->write_index > length)
     {
-        memcpy(&rb->buffer[rb->write_index], data, length);
+        ringbuffer_copy(&rb->buffer[rb->write_index], data, length);
 
         rb->write_index += length;
 
@@ -135,9 +216,9 @@ uint32_t ringbuffer_put_force(ringbuffer *rb, uint8_t *data, uint32_t length)
         return length;
     }
 
-    memcpy(&rb->buffer[rb->write_index], data, rb->buffer_size - rb->write_index);
+    ringbuffer_copy(&rb->buffer[rb->write_index], data, rb->buffer_size - rb->write_index);
 
-    memcpy(&rb->buffer[0], &data[rb->buffer_size - rb->write_index], length - (rb->buffer_size - rb->write_index));
+    ringbuffer_copy(&rb->buffer[0], &data[rb->buffer_size - rb->write_index], length - (rb->buffer_size - rb->write_index));
 
     rb->write_mirror = ~rb->write_mirror;
     rb->write_index = length - (rb->buffer_size - rb->write_index);
@@ -168,16 +249,23 @@ uint32_t ringbuffer_get(ringbuffer *rb, uint8_t *data, uint32_t length)
         length = data_length;
     }
 
+    if (rb->flags & RINGBUFFER_FLAG_MIRRORED)
+    {
+        ringbuffer_copy(data, &rb->buffer[rb->read_index], length);
+        ringbuffer_advance_read(rb, length);
+        return length;
+    }
+
     if (rb->buffer_size - rb->read_index > length)
     {
-        memcpy(data, &rb->buffer[rb->read_index], length);
+        ringbuffer_copy(data, &rb->buffer[rb->read_index], length);
         rb->read_index += length;
         return length;
     }
 
-    memcpy(&data[0], &rb->buffer[rb->read_index], rb->buffer_size - rb->read_index);
+    ringbuffer_copy(&data[0], &rb->buffer[rb->read_index], rb->buffer_size - rb->read_index);
 
-    memcpy(&data[rb->buffer_size - rb->read_index], &rb->buffer[0], length - (rb->buffer_size - rb->read_index));
+    ringbuffer_copy(&data[rb->buffer_size - rb->read_index], &rb->buffer[0], length - (rb->buffer_size - rb->read_index));
 
     rb->read_mirror = ~rb->read_mirror;
     rb->read_index = length - (rb->buffer_size - rb->read_index);
@@ -200,6 +288,12 @@ uint32_t ringbuffer_peek(ringbuffer *rb, uint8_t **ptr)
 
     *ptr = &rb->buffer[rb->read_index];
 
+    if (rb->flags & RINGBUFFER_FLAG_MIRRORED)
+    {
+        ringbuffer_advance_read(rb, data_length);
+        return data_length;
+    }
+
     if ((rb->buffer_size - rb->read_index) > data_length)
     {
         rb->read_index += data_length;
@@ -215,6 +309,80 @@ uint32_t ringbuffer_peek(ringbuffer *rb, uint8_t **ptr)
 
 }
 
+uint32_t ringbuffer_reserve(ringbuffer *rb, uint32_t length, uint8_t **ptr)
+{
+    assert(rb != nullptr);
+
+    uint32_t available_len = ringbuffer_available_len(rb);
+
+    *ptr = &rb->buffer[rb->write_index];
+
+    if (!(rb->flags & RINGBUFFER_FLAG_MIRRORED) && rb->buffer_size - rb->write_index < available_len)
+    {
+        available_len = rb->buffer_size - rb->write_index;
+    }
+
+    return MIN(length, available_len);
+}
+
+uint32_t ringbuffer_commit(ringbuffer *rb, uint32_t length)
+{
+    assert(rb != nullptr);
+
+    uint32_t available_len = ringbuffer_available_len(rb);
+
+    if (available_len < length)
+    {
+        length = available_len;
+    }
+
+    ringbuffer_advance_write(rb, length);
+
+    return length;
+}
+
+int ringbuffer_peek_regions(ringbuffer *rb, struct iovec iov[2])
+{
+    assert(rb != nullptr);
+
+    uint32_t data_length = ringbuffer_data_len(rb);
+
+    if (data_length == 0)
+    {
+        return 0;
+    }
+
+    iov[0].iov_base = &rb->buffer[rb->read_index];
+
+    if ((rb->flags & RINGBUFFER_FLAG_MIRRORED) || rb->buffer_size - rb->read_index >= data_length)
+    {
+        iov[0].iov_len = data_length;
+        return 1;
+    }
+
+    iov[0].iov_len = rb->buffer_size - rb->read_index;
+    iov[1].iov_base = &rb->buffer[0];
+    iov[1].iov_len = data_length - iov[0].iov_len;
+
+    return 2;
+}
+
+uint32_t ringbuffer_consume(ringbuffer *rb, uint32_t length)
+{
+    assert(rb != nullptr);
+
+    uint32_t data_length = ringbuffer_data_len(rb);
+
+    if (data_length < length)
+    {
+        length = data_length;
+    }
+
+    ringbuffer_advance_read(rb, length);
+
+    return length;
+}
+
 uint32_t ringbuffer_data_len(ringbuffer *rb)
 {
     switch (ringbuffer_status_check(rb))
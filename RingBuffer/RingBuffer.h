@@ -6,14 +6,27 @@
 #include <string.h>
 #include <stdint.h>
 #include <assert.h>
+#include <sys/uio.h>
 
-#define MIN(x, y) ((x) < (y)) ? (x) : (y)
+#define MIN(x, y) (((x) < (y)) ? (x) : (y))
 
 #define DEFAULT_ALIGN_SIZE 8
 
+#define RINGBUFFER_CACHELINE_SIZE 64
+
 #define ALIGN(size, align)       (((size) + (align) - 1) & ~((align) - 1))
 #define ALIGN_DOWN(size, align)  ((size) & ~((align) - 1))
 
+#define RINGBUFFER_FLAG_MIRRORED        (1u << 0)   //缓存区在虚拟地址上映射两次，读写区域总是连续
+#define RINGBUFFER_FLAG_ALIGN_CACHELINE (1u << 1)   //缓存区按cache line(64字节)对齐
+#define RINGBUFFER_FLAG_ALIGN_PAGE      (1u << 2)   //缓存区按页对齐，大小向上取整到页
+#define RINGBUFFER_FLAG_HUGEPAGE        (1u << 3)   //使用 MAP_HUGETLB 大页，失败时退回透明大页
+#define RINGBUFFER_FLAG_THP             (1u << 4)   //对缓存区 madvise(MADV_HUGEPAGE)
+#define RINGBUFFER_FLAG_MLOCK           (1u << 5)   //mlock 锁定缓存区，避免换出
+#define RINGBUFFER_FLAG_PREFAULT        (1u << 6)   //创建时预先触发缺页，首轮读写不再缺页
+#define RINGBUFFER_FLAG_NUMA_BOUND      (1u << 30)  //只输出：缓存区已绑定到 numa_node，绑定失败或未指定节点时不设置
+#define RINGBUFFER_FLAG_MMAPPED         (1u << 31)  //内部使用：缓存区由 mmap 分配
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -33,6 +46,7 @@ typedef struct ringbuffer_t
     uint32_t write_mirror : 1;
     uint32_t write_index : 31;
     uint32_t buffer_size;
+    uint32_t flags;
     uint8_t *buffer;
 } ringbuffer;
 
@@ -44,6 +58,28 @@ typedef struct ringbuffer_t
 */
 ringbuffer* ringbuffer_create(uint32_t length);
 
+/**
+/*@brief 按创建标志创建ringbuffer
+/*
+/*@param length 缓存区大小，按对齐/大页要求向上取整
+/*@param flags RINGBUFFER_FLAG_* 组合
+/*@param numa_node 缓存区绑定的NUMA节点，小于0表示不绑定
+/*@return ringbuffer* 失败返回nullptr
+*/
+ringbuffer* ringbuffer_create_ex(uint32_t length, uint32_t flags, int numa_node);
+
+/**
+/*@brief 创建镜像映射的ringbuffer
+/*
+/* 同一块物理内存(memfd)被连续映射两次，buffer[i] 与 buffer[i + size] 是同一字节，
+/* 任意可读/可写区域在地址上都是连续的，读写不再需要在回绕处拆分，
+/* ringbuffer_peek 可以一次返回全部可读数据
+/*
+/*@param length 缓存区大小，向上对齐到页大小
+/*@return ringbuffer* 失败返回nullptr
+*/
+ringbuffer* ringbuffer_create_mirrored(uint32_t length);
+
 /**
 /*@brief 销毁ringbuffer
 /*
@@ -101,12 +137,51 @@ uint32_t ringbuffer_get(ringbuffer *rb, uint8_t *data, uint32_t length);
 /**
 /*@brief 获取 ringbuffer 可读位置
 /*
+/* 注意：返回的数据视为已读取，读位置会前移；只查看不消费请使用 ringbuffer_peek_regions
+/*
 /*@param rb ringbuffer指针
 /*@param ptr 第一个可读数据指针
 /*@return uint32_t 数据长度
  */
 uint32_t ringbuffer_peek(ringbuffer *rb, uint8_t **ptr);
 
+/**
+/*@brief 预留一段连续可写空间，调用者直接在 ringbuffer 内序列化数据
+/*
+/*@param rb ringbuffer指针
+/*@param length 期望长度
+/*@param ptr 可写区域指针
+/*@return uint32_t 实际可写的连续长度，可能小于 length，空间不足时为0
+ */
+uint32_t ringbuffer_reserve(ringbuffer *rb, uint32_t length, uint8_t **ptr);
+
+/**
+/*@brief 提交 ringbuffer_reserve 预留区域中已写入的数据
+/*
+/*@param rb ringbuffer指针
+/*@param length 提交长度，不超过预留长度
+/*@return uint32_t 实际提交长度
+ */
+uint32_t ringbuffer_commit(ringbuffer *rb, uint32_t length);
+
+/**
+/*@brief 获取全部可读数据所在的区域，不移动读位置
+/*
+/*@param rb ringbuffer指针
+/*@param iov 输出的区域数组，至少2个元素，数据在回绕处被分成两段
+/*@return int 有效区域个数 0~2
+ */
+int ringbuffer_peek_regions(ringbuffer *rb, struct iovec iov[2]);
+
+/**
+/*@brief 丢弃已读取的数据，与 ringbuffer_peek_regions 配合使用
+/*
+/*@param rb ringbuffer指针
+/*@param length 丢弃长度
+/*@return uint32_t 实际丢弃长度
+ */
+uint32_t ringbuffer_consume(ringbuffer *rb, uint32_t length);
+
 /**
 /*@brief 获取ringbuffer数据长度
 /*
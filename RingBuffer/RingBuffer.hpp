@@ -0,0 +1,250 @@
+#ifndef __RINGBUFFER_HPP__
+#define __RINGBUFFER_HPP__
+
+#include <stddef.h>
+#include <string.h>
+#include <new>
+#include <utility>
+#include <type_traits>
+
+/**
+/*@brief 编译期定长的元素ringbuffer
+/*
+/* 容量 N 必须是2的幂，下标计算是 & (N - 1)；head/tail 是只增不减的计数。
+/* 元素类型可平凡拷贝时批量读写退化为最多两次 memcpy，编译器可以展开和向量化。
+/* 与 ringbuffer 一样不是线程安全的，跨线程使用需要外部加锁。
+*/
+template <typename T, size_t N>
+class RingBuffer
+{
+    static_assert(N > 0 && (N & (N - 1)) == 0, "RingBuffer capacity must be a power of two");
+
+public:
+    RingBuffer();
+    ~RingBuffer();
+
+    RingBuffer(const RingBuffer &) = delete;
+    RingBuffer &operator=(const RingBuffer &) = delete;
+
+    /**
+    /*@brief 入队
+    /*
+    /*@param item 入队元素
+    /*@return false 队列已满
+    */
+    bool push(const T &item);
+
+    bool push(T &&item);
+
+    /**
+    /*@brief 在队尾原地构造元素
+    /*
+    /*@param args 构造参数
+    /*@return false 队列已满
+    */
+    template <typename... Args>
+    bool emplace(Args &&...args);
+
+    /**
+    /*@brief 出队
+    /*
+    /*@param item 出队元素
+    /*@return false 队列为空
+    */
+    bool pop(T &item);
+
+    /**
+    /*@brief 获取队头元素，不出队
+    /*
+    /*@return T* 队列为空返回nullptr
+    */
+    T *front();
+
+    /**
+    /*@brief 批量入队
+    /*
+    /*@param items 元素数组
+    /*@param count 元素数量
+    /*@return size_t 实际入队数量
+    */
+    size_t push_bulk(const T *items, size_t count);
+
+    /**
+    /*@brief 批量出队
+    /*
+    /*@param items 输出数组
+    /*@param count 最大出队数量
+    /*@return size_t 实际出队数量
+    */
+    size_t pop_bulk(T *items, size_t count);
+
+    void clear();
+
+    size_t size() const { return m_head - m_tail; }
+
+    bool empty() const { return m_head == m_tail; }
+
+    bool full() const { return size() == N; }
+
+    static constexpr size_t capacity() { return N; }
+
+private:
+    static constexpr size_t kMask = N - 1;
+
+    T *slot(size_t pos) { return reinterpret_cast<T *>(m_storage) + (pos & kMask); }
+
+    // 平凡拷贝类型按字节搬运，最多拆成两段
+    static void copy_in(T *ring, size_t index, const T *items, size_t count, std::true_type);
+    static void copy_in(T *ring, size_t index, const T *items, size_t count, std::false_type);
+    static void copy_out(T *ring, size_t index, T *items, size_t count, std::true_type);
+    static void copy_out(T *ring, size_t index, T *items, size_t count, std::false_type);
+
+    typedef std::integral_constant<bool, std::is_trivially_copyable<T>::value> trivial_t;
+
+    size_t m_head;  //已入队总数
+    size_t m_tail;  //已出队总数
+    alignas(T) unsigned char m_storage[N * sizeof(T)];
+};
+
+template <typename T, size_t N>
+inline RingBuffer<T, N>::RingBuffer() : m_head(0), m_tail(0)
+{
+}
+
+template <typename T, size_t N>
+inline RingBuffer<T, N>::~RingBuffer()
+{
+    clear();
+}
+
+template <typename T, size_t N>
+inline bool RingBuffer<T, N>::push(const T &item)
+{
+    return emplace(item);
+}
+
+template <typename T, size_t N>
+inline bool RingBuffer<T, N>::push(T &&item)
+{
+    return emplace(std::move(item));
+}
+
+template <typename T, size_t N>
+template <typename... Args>
+inline bool RingBuffer<T, N>::emplace(Args &&...args)
+{
+    if (full())
+    {
+        return false;
+    }
+
+    new (slot(m_head)) T(std::forward<Args>(args)...);
+    ++m_head;
+    return true;
+}
+
+template <typename T, size_t N>
+inline bool RingBuffer<T, N>::pop(T &item)
+{
+    if (empty())
+    {
+        return false;
+    }
+
+    T *ptr = slot(m_tail);
+    item = std::move(*ptr);
+    ptr->~T();
+    ++m_tail;
+    return true;
+}
+
+template <typename T, size_t N>
+inline T *RingBuffer<T, N>::front()
+{
+    return empty() ? nullptr : slot(m_tail);
+}
+
+template <typename T, size_t N>
+inline size_t RingBuffer<T, N>::push_bulk(const T *items, size_t count)
+{
+    if (count > N - size())
+    {
+        count = N - size();
+    }
+
+    copy_in(reinterpret_cast<T *>(m_storage), m_head & kMask, items, count, trivial_t());
+    m_head += count;
+    return count;
+}
+
+template <typename T, size_t N>
+inline size_t RingBuffer<T, N>::pop_bulk(T *items, size_t count)
+{
+    if (count > size())
+    {
+        count = size();
+    }
+
+    copy_out(reinterpret_cast<T *>(m_storage), m_tail & kMask, items, count, trivial_t());
+    m_tail += count;
+    return count;
+}
+
+template <typename T, size_t N>
+inline void RingBuffer<T, N>::clear()
+{
+    if (!std::is_trivially_destructible<T>::value)
+    {
+        for (size_t pos = m_tail; pos != m_head; ++pos)
+        {
+            slot(pos)->~T();
+        }
+    }
+    m_head = m_tail = 0;
+}
+
+template <typename T, size_t N>
+inline void RingBuffer<T, N>::copy_in(T *ring, size_t index, const T *items, size_t count, std::true_type)
+{
+    size_t first = count < N - index ? count : N - index;
+
+    memcpy(ring + index, items, first * sizeof(T));
+    if (first < count)
+    {
+        memcpy(ring, items + first, (count - first) * sizeof(T));
+    }
+}
+
+template <typename T, size_t N>
+inline void RingBuffer<T, N>::copy_in(T *ring, size_t index, const T *items, size_t count, std::false_type)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        new (ring + ((index + i) & kMask)) T(items[i]);
+    }
+}
+
+template <typename T, size_t N>
+inline void RingBuffer<T, N>::copy_out(T *ring, size_t index, T *items, size_t count, std::true_type)
+{
+    size_t first = count < N - index ? count : N - index;
+
+    memcpy(items, ring + index, first * sizeof(T));
+    if (first < count)
+    {
+        memcpy(items + first, ring, (count - first) * sizeof(T));
+    }
+}
+
+template <typename T, size_t N>
+inline void RingBuffer<T, N>::copy_out(T *ring, size_t index, T *items, size_t count, std::false_type)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        T *ptr = ring + ((index + i) & kMask);
+        items[i] = std::move(*ptr);
+        ptr->~T();
+    }
+}
+
+#endif /* __RINGBUFFER_HPP__ */
@@ -0,0 +1,140 @@
+#include "RingBuffer64.h"
+#include "RingBufferCopy.h"
+
+// 向上取整到2的幂
+static uint64_t ringbuffer64_roundup_pow2(uint64_t length)
+{
+    return length <= 1 ? 1 : 1ull << (64 - __builtin_clzll(length - 1));
+}
+
+ringbuffer64 *ringbuffer64_create(uint64_t length)
+{
+    ringbuffer64 *rb = nullptr;
+    uint8_t *pool = nullptr;
+
+    assert(length > 0 && length <= (1ull << 63));
+
+    length = ringbuffer64_roundup_pow2(length);
+
+    rb = (ringbuffer64 *)malloc(sizeof(ringbuffer64));
+    if (rb == nullptr)
+    {
+        goto exit;
+    }
+
+    pool = (uint8_t *)malloc(length);
+    if (pool == nullptr)
+    {
+        free(rb);
+        rb = nullptr;
+        goto exit;
+    }
+
+    ringbuffer64_init(rb, pool, length);
+
+exit:
+    return rb;
+}
+
+void ringbuffer64_destroy(ringbuffer64 *rb)
+{
+    assert(rb != nullptr);
+
+    free(rb->buffer);
+    free(rb);
+}
+
+void ringbuffer64_init(ringbuffer64 *rb, uint8_t *buffer, uint64_t length)
+{
+    assert(rb != nullptr);
+    assert(length > 0 && (length & (length - 1)) == 0);
+
+    rb->head = rb->tail = 0;
+    rb->mask = length - 1;
+    rb->buffer = buffer;
+}
+
+void ringbuffer64_reset(ringbuffer64 *rb)
+{
+    assert(rb != nullptr);
+
+    rb->head = rb->tail = 0;
+}
+
+uint64_t ringbuffer64_put(ringbuffer64 *rb, const uint8_t *data, uint64_t length)
+{
+    assert(rb != nullptr);
+
+    length = MIN(length, ringbuffer64_available_len(rb));
+
+    uint64_t index = rb->head & rb->mask;
+    uint64_t first = MIN(length, rb->mask + 1 - index);
+
+    ringbuffer_copy(&rb->buffer[index], data, first);
+    if (first < length)
+    {
+        ringbuffer_copy(&rb->buffer[0], &data[first], length - first);
+    }
+
+    rb->head += length;
+
+    return length;
+}
+
+uint64_t ringbuffer64_get(ringbuffer64 *rb, uint8_t *data, uint64_t length)
+{
+    assert(rb != nullptr);
+
+    length = MIN(length, ringbuffer64_data_len(rb));
+
+    uint64_t index = rb->tail & rb->mask;
+    uint64_t first = MIN(length, rb->mask + 1 - index);
+
+    ringbuffer_copy(data, &rb->buffer[index], first);
+    if (first < length)
+    {
+        ringbuffer_copy(&data[first], &rb->buffer[0], length - first);
+    }
+
+    rb->tail += length;
+
+    return length;
+}
+
+int ringbuffer64_peek_regions(ringbuffer64 *rb, struct iovec iov[2])
+{
+    assert(rb != nullptr);
+
+    uint64_t data_length = ringbuffer64_data_len(rb);
+
+    if (data_length == 0)
+    {
+        return 0;
+    }
+
+    uint64_t index = rb->tail & rb->mask;
+
+    iov[0].iov_base = &rb->buffer[index];
+    iov[0].iov_len = MIN(data_length, rb->mask + 1 - index);
+
+    if (iov[0].iov_len == data_length)
+    {
+        return 1;
+    }
+
+    iov[1].iov_base = &rb->buffer[0];
+    iov[1].iov_len = data_length - iov[0].iov_len;
+
+    return 2;
+}
+
+uint64_t ringbuffer64_consume(ringbuffer64 *rb, uint64_t length)
+{
+    assert(rb != nullptr);
+
+    length = MIN(length, ringbuffer64_data_len(rb));
+
+    rb->tail += length;
+
+    return length;
+}
@@ -0,0 +1,102 @@
+#ifndef __RINGBUFFER64_H__
+#define __RINGBUFFER64_H__
+
+#include "RingBuffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+/*@brief 64位计数、容量为2的幂的ringbuffer
+/*
+/* head/tail 是只增不减的64位字节计数，不会回绕。
+/* 数据长度 = head - tail，可写长度 = size - (head - tail)，缓存区下标 = 计数 & mask，
+/* 没有 mirror 位和状态分支，容量也不再受31位下标限制。
+*/
+typedef struct ringbuffer64_t
+{
+    uint64_t head;      //已写入的总字节数
+    uint64_t tail;      //已读取的总字节数
+    uint64_t mask;      //buffer_size - 1
+    uint8_t *buffer;
+} ringbuffer64;
+
+/**
+/*@brief 创建ringbuffer64
+/*
+/*@param length 缓存区大小，向上取整到2的幂
+/*@return ringbuffer64* 
+*/
+ringbuffer64* ringbuffer64_create(uint64_t length);
+
+/**
+/*@brief 销毁ringbuffer64
+/*
+/*@param rb ringbuffer指针
+ */
+void ringbuffer64_destroy(ringbuffer64 *rb);
+
+/**
+/*@brief 初始化ringbuffer64
+/*
+/*@param rb ringbuffer指针
+/*@param buffer 缓存区指针
+/*@param length 缓存区大小，必须是2的幂
+ */
+void ringbuffer64_init(ringbuffer64 *rb, uint8_t *buffer, uint64_t length);
+
+/**
+/*@brief 重置ringbuffer64
+/*
+/*@param rb ringbuffer指针
+ */
+void ringbuffer64_reset(ringbuffer64 *rb);
+
+/**
+/*@brief 向ringbuffer写入数据
+/*
+/*@param rb ringbuffer指针
+/*@param data 数据指针
+/*@param length 数据长度
+/*@return uint64_t 实际写入长度
+ */
+uint64_t ringbuffer64_put(ringbuffer64 *rb, const uint8_t *data, uint64_t length);
+
+/**
+/*@brief 从ringbuffer读取数据
+/*
+/*@param rb ringbuffer指针
+/*@param data 数据指针
+/*@param length 数据长度
+/*@return uint64_t 实际读取长度
+ */
+uint64_t ringbuffer64_get(ringbuffer64 *rb, uint8_t *data, uint64_t length);
+
+/**
+/*@brief 获取全部可读数据所在的区域，不移动读位置
+/*
+/*@param rb ringbuffer指针
+/*@param iov 输出的区域数组，至少2个元素
+/*@return int 有效区域个数 0~2
+ */
+int ringbuffer64_peek_regions(ringbuffer64 *rb, struct iovec iov[2]);
+
+/**
+/*@brief 丢弃已读取的数据
+/*
+/*@param rb ringbuffer指针
+/*@param length 丢弃长度
+/*@return uint64_t 实际丢弃长度
+ */
+uint64_t ringbuffer64_consume(ringbuffer64 *rb, uint64_t length);
+
+#define ringbuffer64_data_len(rb)       ((rb)->head - (rb)->tail)
+#define ringbuffer64_get_size(rb)       ((rb)->mask + 1)
+#define ringbuffer64_available_len(rb)  (ringbuffer64_get_size(rb) - ringbuffer64_data_len(rb))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RINGBUFFER64_H__ */
@@ -0,0 +1,229 @@
+#include "RingBufferBroadcast.h"
+#include "RingBufferInternal.h"
+#include <time.h>
+#include <sched.h>
+
+#define RINGBUFFER_BCAST_HDR_SIZE   8       //槽位头，保存记录长度
+#define RINGBUFFER_BCAST_SPIN_COUNT 256
+
+static inline uint8_t *bcast_slot(ringbuffer_bcast *rb, uint64_t sequence)
+{
+    return &rb->slots[(sequence & rb->mask) * rb->slot_stride];
+}
+
+// 所有消费者中最小的序号，没有消费者时生产者不受限制
+static uint64_t bcast_min_sequence(ringbuffer_bcast *rb, uint64_t cursor)
+{
+    uint64_t min_seq = cursor;
+
+    for (uint32_t i = 0; i < rb->consumer_count; ++i)
+    {
+        uint64_t seq = __atomic_load_n(&rb->consumers[i].sequence, __ATOMIC_ACQUIRE);
+        if (seq < min_seq)
+        {
+            min_seq = seq;
+        }
+    }
+    return min_seq;
+}
+
+ringbuffer_bcast *ringbuffer_bcast_create(uint32_t slot_count, uint32_t slot_size)
+{
+    ringbuffer_bcast *rb = nullptr;
+    uint8_t *pool = nullptr;
+    uint32_t stride = ALIGN(RINGBUFFER_BCAST_HDR_SIZE + slot_size, DEFAULT_ALIGN_SIZE);
+
+    assert(slot_count > 0 && slot_count <= (1u << 31) && slot_size > 0);
+
+    slot_count = slot_count <= 1 ? 1 : 1u << (32 - __builtin_clz(slot_count - 1));
+
+    if (posix_memalign((void **)&rb, RINGBUFFER_CACHELINE_SIZE, sizeof(ringbuffer_bcast)) != 0)
+    {
+        rb = nullptr;
+        goto exit;
+    }
+
+    if (posix_memalign((void **)&pool, RINGBUFFER_CACHELINE_SIZE, (size_t)slot_count * stride) != 0)
+    {
+        free(rb);
+        rb = nullptr;
+        goto exit;
+    }
+
+    memset(rb, 0, sizeof(ringbuffer_bcast));
+    rb->mask = slot_count - 1;
+    rb->slot_size = slot_size;
+    rb->slot_stride = stride;
+    rb->slots = pool;
+
+exit:
+    return rb;
+}
+
+void ringbuffer_bcast_destroy(ringbuffer_bcast *rb)
+{
+    assert(rb != nullptr);
+
+    free(rb->slots);
+    free(rb);
+}
+
+int ringbuffer_bcast_add_consumer(ringbuffer_bcast *rb, const int *deps, int dep_count)
+{
+    assert(rb != nullptr);
+
+    int id = (int)rb->consumer_count;
+
+    // 依赖数量不超过已注册的消费者数量，也就不会超过 deps 数组大小
+    if (id >= RINGBUFFER_BCAST_MAX_CONSUMERS || dep_count < 0 || dep_count > id || (dep_count > 0 && !deps))
+    {
+        return -1;
+    }
+
+    ringbuffer_bcast_consumer *consumer = &rb->consumers[id];
+
+    // 只能依赖已注册的消费者，保证依赖关系无环
+    for (int i = 0; i < dep_count; ++i)
+    {
+        if (deps[i] < 0 || deps[i] >= id)
+        {
+            return -1;
+        }
+        consumer->deps[i] = (uint32_t)deps[i];
+    }
+
+    consumer->dep_count = (uint32_t)dep_count;
+    consumer->sequence = rb->cursor;
+    __atomic_store_n(&rb->consumer_count, rb->consumer_count + 1, __ATOMIC_RELEASE);
+
+    return id;
+}
+
+uint8_t *ringbuffer_bcast_claim(ringbuffer_bcast *rb, uint64_t *sequence)
+{
+    assert(rb != nullptr);
+
+    uint64_t cursor = rb->cursor;
+
+    if (cursor - rb->gating_cache > rb->mask)
+    {
+        rb->gating_cache = bcast_min_sequence(rb, cursor);
+        if (cursor - rb->gating_cache > rb->mask)
+        {
+            return nullptr;
+        }
+    }
+
+    *sequence = cursor;
+
+    return bcast_slot(rb, cursor) + RINGBUFFER_BCAST_HDR_SIZE;
+}
+
+void ringbuffer_bcast_publish(ringbuffer_bcast *rb, uint64_t sequence, uint32_t length)
+{
+    assert(rb != nullptr);
+    assert(sequence == rb->cursor && length <= rb->slot_size);
+
+    *(uint32_t *)bcast_slot(rb, sequence) = length;
+
+    __atomic_store_n(&rb->cursor, sequence + 1, __ATOMIC_RELEASE);
+}
+
+uint32_t ringbuffer_bcast_put(ringbuffer_bcast *rb, const uint8_t *data, uint32_t length)
+{
+    assert(rb != nullptr);
+
+    uint64_t sequence = 0;
+
+    if (length > rb->slot_size)
+    {
+        return 0;
+    }
+
+    uint8_t *ptr = ringbuffer_bcast_claim(rb, &sequence);
+    if (ptr == nullptr)
+    {
+        return 0;
+    }
+
+    memcpy(ptr, data, length);
+    ringbuffer_bcast_publish(rb, sequence, length);
+
+    return length;
+}
+
+uint64_t ringbuffer_bcast_poll(ringbuffer_bcast *rb, int consumer, uint64_t *first)
+{
+    assert(rb != nullptr && consumer >= 0 && (uint32_t)consumer < rb->consumer_count);
+
+    ringbuffer_bcast_consumer *self = &rb->consumers[consumer];
+    uint64_t limit = __atomic_load_n(&rb->cursor, __ATOMIC_ACQUIRE);
+
+    for (uint32_t i = 0; i < self->dep_count; ++i)
+    {
+        uint64_t seq = __atomic_load_n(&rb->consumers[self->deps[i]].sequence, __ATOMIC_ACQUIRE);
+        if (seq < limit)
+        {
+            limit = seq;
+        }
+    }
+
+    *first = self->sequence;
+
+    return limit - self->sequence;
+}
+
+uint64_t ringbuffer_bcast_wait(ringbuffer_bcast *rb, int consumer, uint64_t *first, int timeout_ms)
+{
+    struct timespec start, now;
+    uint64_t count = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (uint32_t spins = 0; ; ++spins)
+    {
+        count = ringbuffer_bcast_poll(rb, consumer, first);
+        if (count > 0)
+        {
+            break;
+        }
+
+        if (spins < RINGBUFFER_BCAST_SPIN_COUNT)
+        {
+            cpu_relax();
+            continue;
+        }
+
+        if (timeout_ms >= 0)
+        {
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            if ((now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000 >= timeout_ms)
+            {
+                break;
+            }
+        }
+        sched_yield();
+    }
+
+    return count;
+}
+
+uint8_t *ringbuffer_bcast_record(ringbuffer_bcast *rb, uint64_t sequence, uint32_t *length)
+{
+    assert(rb != nullptr);
+
+    uint8_t *slot = bcast_slot(rb, sequence);
+
+    *length = *(uint32_t *)slot;
+
+    return slot + RINGBUFFER_BCAST_HDR_SIZE;
+}
+
+void ringbuffer_bcast_release(ringbuffer_bcast *rb, int consumer, uint64_t count)
+{
+    assert(rb != nullptr && consumer >= 0 && (uint32_t)consumer < rb->consumer_count);
+
+    ringbuffer_bcast_consumer *self = &rb->consumers[consumer];
+
+    __atomic_store_n(&self->sequence, self->sequence + count, __ATOMIC_RELEASE);
+}
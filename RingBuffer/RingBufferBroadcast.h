@@ -0,0 +1,145 @@
+#ifndef __RINGBUFFER_BROADCAST_H__
+#define __RINGBUFFER_BROADCAST_H__
+
+#include "RingBufferSpsc.h"
+
+#define RINGBUFFER_BCAST_MAX_CONSUMERS 16
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+/*@brief 广播ringbuffer的消费者
+/*
+*/
+typedef struct ringbuffer_bcast_consumer_t
+{
+    uint64_t sequence __cacheline_aligned;          //下一条要处理的记录序号，之前的记录都已处理完
+    uint32_t dep_count;                             //依赖的消费者数量
+    uint32_t deps[RINGBUFFER_BCAST_MAX_CONSUMERS];  //依赖的消费者编号
+} ringbuffer_bcast_consumer;
+
+/**
+/*@brief 单生产者多消费者广播ringbuffer (Disruptor)
+/*
+/* 记录保存在固定大小的槽位中，槽位数量为2的幂，序号 & mask 即槽位下标。
+/* 生产者只有一个写游标 cursor，每个消费者有独立的序号，所有消费者都能读到每一条记录，数据不做拷贝。
+/* 生产者只被最慢的消费者限制；消费者可以声明依赖，只能处理被依赖消费者已处理完的记录，
+/* 从而组成 解码 -> (日志, 统计) -> 转发 这样的流水线。
+*/
+typedef struct ringbuffer_bcast_t
+{
+    uint64_t cursor __cacheline_aligned;    //下一条要发布的记录序号，只由生产者修改
+    uint64_t gating_cache;                  //生产者缓存的最慢消费者序号
+
+    uint64_t mask __cacheline_aligned;      //槽位数量 - 1
+    uint32_t slot_size;                     //每个槽位可存放的最大记录长度
+    uint32_t slot_stride;                   //槽位间距
+    uint32_t consumer_count;
+    uint8_t *slots;
+
+    ringbuffer_bcast_consumer consumers[RINGBUFFER_BCAST_MAX_CONSUMERS];
+} ringbuffer_bcast;
+
+/**
+/*@brief 创建广播ringbuffer
+/*
+/*@param slot_count 槽位数量，向上取整到2的幂
+/*@param slot_size 单条记录最大长度
+/*@return ringbuffer_bcast*
+*/
+ringbuffer_bcast* ringbuffer_bcast_create(uint32_t slot_count, uint32_t slot_size);
+
+/**
+/*@brief 销毁广播ringbuffer
+/*
+/*@param rb ringbuffer指针
+ */
+void ringbuffer_bcast_destroy(ringbuffer_bcast *rb);
+
+/**
+/*@brief 注册消费者，必须在生产者开始写入之前完成
+/*
+/*@param rb ringbuffer指针
+/*@param deps 依赖的消费者编号数组，可以为nullptr
+/*@param dep_count 依赖数量，不能超过已注册的消费者数量
+/*@return int 消费者编号，失败返回-1
+ */
+int ringbuffer_bcast_add_consumer(ringbuffer_bcast *rb, const int *deps, int dep_count);
+
+/**
+/*@brief 申请一个槽位，调用者直接在槽位中构造记录，然后调用 ringbuffer_bcast_publish
+/*
+/*@param rb ringbuffer指针
+/*@param sequence 输出的记录序号
+/*@return uint8_t* 槽位数据指针，可写 slot_size 字节；最慢的消费者还没处理完时返回nullptr
+ */
+uint8_t* ringbuffer_bcast_claim(ringbuffer_bcast *rb, uint64_t *sequence);
+
+/**
+/*@brief 发布已申请的记录，消费者随后可以看到
+/*
+/*@param rb ringbuffer指针
+/*@param sequence ringbuffer_bcast_claim 返回的序号
+/*@param length 记录长度
+ */
+void ringbuffer_bcast_publish(ringbuffer_bcast *rb, uint64_t sequence, uint32_t length);
+
+/**
+/*@brief 拷贝写入一条记录
+/*
+/*@param rb ringbuffer指针
+/*@param data 记录指针
+/*@param length 记录长度，不超过 slot_size
+/*@return uint32_t 写入长度，没有空闲槽位返回0
+ */
+uint32_t ringbuffer_bcast_put(ringbuffer_bcast *rb, const uint8_t *data, uint32_t length);
+
+/**
+/*@brief 查询消费者可以处理的记录
+/*
+/* 可处理的记录受生产者游标和所有依赖消费者的序号共同限制
+/*
+/*@param rb ringbuffer指针
+/*@param consumer 消费者编号
+/*@param first 输出第一条可处理记录的序号
+/*@return uint64_t 可处理的记录数量
+ */
+uint64_t ringbuffer_bcast_poll(ringbuffer_bcast *rb, int consumer, uint64_t *first);
+
+/**
+/*@brief 阻塞等待消费者有可处理的记录，自旋后让出CPU
+/*
+/*@param rb ringbuffer指针
+/*@param consumer 消费者编号
+/*@param first 输出第一条可处理记录的序号
+/*@param timeout_ms 超时时间(毫秒)，小于0表示一直等待
+/*@return uint64_t 可处理的记录数量，超时返回0
+ */
+uint64_t ringbuffer_bcast_wait(ringbuffer_bcast *rb, int consumer, uint64_t *first, int timeout_ms);
+
+/**
+/*@brief 获取记录
+/*
+/*@param rb ringbuffer指针
+/*@param sequence 记录序号
+/*@param length 输出记录长度
+/*@return uint8_t* 记录数据指针，在 ringbuffer_bcast_release 之前有效
+ */
+uint8_t* ringbuffer_bcast_record(ringbuffer_bcast *rb, uint64_t sequence, uint32_t *length);
+
+/**
+/*@brief 标记消费者已处理完 count 条记录
+/*
+/*@param rb ringbuffer指针
+/*@param consumer 消费者编号
+/*@param count 记录数量
+ */
+void ringbuffer_bcast_release(ringbuffer_bcast *rb, int consumer, uint64_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RINGBUFFER_BROADCAST_H__ */
@@ -0,0 +1,287 @@
+#include "RingBufferCopy.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define RINGBUFFER_COPY_X86 1
+#endif
+
+#define CRC32C_POLY 0x82F63B78u     //Castagnoli 反射多项式
+
+typedef void (*copy_kernel_t)(uint8_t *dst, const uint8_t *src, size_t length);
+typedef uint32_t (*crc_kernel_t)(uint32_t crc, uint8_t *dst, const uint8_t *src, size_t length);
+
+static uint32_t crc32c_table[256];
+
+static void copy_memcpy(uint8_t *dst, const uint8_t *src, size_t length)
+{
+    memcpy(dst, src, length);
+}
+
+/**
+/*@brief 查表实现的CRC32C，dst 非空时同时拷贝
+/*
+*/
+static uint32_t crc32c_soft(uint32_t crc, uint8_t *dst, const uint8_t *src, size_t length)
+{
+    for (size_t i = 0; i < length; ++i)
+    {
+        crc = crc32c_table[(crc ^ src[i]) & 0xff] ^ (crc >> 8);
+    }
+    if (dst != nullptr)
+    {
+        memcpy(dst, src, length);
+    }
+    return crc;
+}
+
+#ifdef RINGBUFFER_COPY_X86
+
+// 非临时存储要求目的地址对齐，先用 memcpy 拷贝到对齐位置
+#define COPY_ALIGN_HEAD(dst, src, length, align)                                \
+    do                                                                          \
+    {                                                                           \
+        size_t head = (size_t)(-(uintptr_t)(dst)) & ((align) - 1);              \
+        head = MIN(head, length);                                               \
+        memcpy(dst, src, head);                                                 \
+        dst += head;                                                            \
+        src += head;                                                            \
+        length -= head;                                                         \
+    } while (0)
+
+__attribute__((target("sse2")))
+static void copy_sse2(uint8_t *dst, const uint8_t *src, size_t length)
+{
+    bool nt = length >= RINGBUFFER_COPY_NT_THRESHOLD;
+
+    if (nt)
+    {
+        COPY_ALIGN_HEAD(dst, src, length, 16);
+    }
+
+    for (; length >= 64; length -= 64, src += 64, dst += 64)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i *)(src + 0));
+        __m128i b = _mm_loadu_si128((const __m128i *)(src + 16));
+        __m128i c = _mm_loadu_si128((const __m128i *)(src + 32));
+        __m128i d = _mm_loadu_si128((const __m128i *)(src + 48));
+        if (nt)
+        {
+            _mm_stream_si128((__m128i *)(dst + 0), a);
+            _mm_stream_si128((__m128i *)(dst + 16), b);
+            _mm_stream_si128((__m128i *)(dst + 32), c);
+            _mm_stream_si128((__m128i *)(dst + 48), d);
+        }
+        else
+        {
+            _mm_storeu_si128((__m128i *)(dst + 0), a);
+            _mm_storeu_si128((__m128i *)(dst + 16), b);
+            _mm_storeu_si128((__m128i *)(dst + 32), c);
+            _mm_storeu_si128((__m128i *)(dst + 48), d);
+        }
+    }
+
+    if (nt)
+    {
+        _mm_sfence();
+    }
+    memcpy(dst, src, length);
+}
+
+__attribute__((target("avx2")))
+static void copy_avx2(uint8_t *dst, const uint8_t *src, size_t length)
+{
+    bool nt = length >= RINGBUFFER_COPY_NT_THRESHOLD;
+
+    if (nt)
+    {
+        COPY_ALIGN_HEAD(dst, src, length, 32);
+    }
+
+    for (; length >= 128; length -= 128, src += 128, dst += 128)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(src + 0));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(src + 32));
+        __m256i c = _mm256_loadu_si256((const __m256i *)(src + 64));
+        __m256i d = _mm256_loadu_si256((const __m256i *)(src + 96));
+        if (nt)
+        {
+            _mm256_stream_si256((__m256i *)(dst + 0), a);
+            _mm256_stream_si256((__m256i *)(dst + 32), b);
+            _mm256_stream_si256((__m256i *)(dst + 64), c);
+            _mm256_stream_si256((__m256i *)(dst + 96), d);
+        }
+        else
+        {
+            _mm256_storeu_si256((__m256i *)(dst + 0), a);
+            _mm256_storeu_si256((__m256i *)(dst + 32), b);
+            _mm256_storeu_si256((__m256i *)(dst + 64), c);
+            _mm256_storeu_si256((__m256i *)(dst + 96), d);
+        }
+    }
+
+    if (nt)
+    {
+        _mm_sfence();
+    }
+    memcpy(dst, src, length);
+}
+
+__attribute__((target("avx512f")))
+static void copy_avx512(uint8_t *dst, const uint8_t *src, size_t length)
+{
+    bool nt = length >= RINGBUFFER_COPY_NT_THRESHOLD;
+
+    if (nt)
+    {
+        COPY_ALIGN_HEAD(dst, src, length, 64);
+    }
+
+    for (; length >= 256; length -= 256, src += 256, dst += 256)
+    {
+        __m512i a = _mm512_loadu_si512((const void *)(src + 0));
+        __m512i b = _mm512_loadu_si512((const void *)(src + 64));
+        __m512i c = _mm512_loadu_si512((const void *)(src + 128));
+        __m512i d = _mm512_loadu_si512((const void *)(src + 192));
+        if (nt)
+        {
+            _mm512_stream_si512((__m512i *)(dst + 0), a);
+            _mm512_stream_si512((__m512i *)(dst + 64), b);
+            _mm512_stream_si512((__m512i *)(dst + 128), c);
+            _mm512_stream_si512((__m512i *)(dst + 192), d);
+        }
+        else
+        {
+            _mm512_storeu_si512((void *)(dst + 0), a);
+            _mm512_storeu_si512((void *)(dst + 64), b);
+            _mm512_storeu_si512((void *)(dst + 128), c);
+            _mm512_storeu_si512((void *)(dst + 192), d);
+        }
+    }
+
+    if (nt)
+    {
+        _mm_sfence();
+    }
+    memcpy(dst, src, length);
+}
+
+/**
+/*@brief SSE4.2 crc32指令实现，每次处理8字节，dst 非空时同时写出
+/*
+*/
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_sse42(uint32_t crc, uint8_t *dst, const uint8_t *src, size_t length)
+{
+    uint64_t crc64 = crc;
+
+    for (; length >= 8; length -= 8, src += 8)
+    {
+        uint64_t word;
+        memcpy(&word, src, 8);
+        crc64 = _mm_crc32_u64(crc64, word);
+        if (dst != nullptr)
+        {
+            memcpy(dst, &word, 8);
+            dst += 8;
+        }
+    }
+
+    crc = (uint32_t)crc64;
+    for (; length > 0; --length, ++src)
+    {
+        crc = _mm_crc32_u8(crc, *src);
+        if (dst != nullptr)
+        {
+            *dst++ = *src;
+        }
+    }
+    return crc;
+}
+
+#endif /* RINGBUFFER_COPY_X86 */
+
+static copy_kernel_t copy_kernel = copy_memcpy;
+static crc_kernel_t crc_kernel = crc32c_soft;
+static const char *copy_isa = "memcpy";
+
+/**
+/*@brief 进程启动时按CPU特性选择实现
+/*
+*/
+__attribute__((constructor))
+static void ringbuffer_copy_dispatch(void)
+{
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        uint32_t crc = i;
+        for (int k = 0; k < 8; ++k)
+        {
+            crc = (crc >> 1) ^ (CRC32C_POLY & (0u - (crc & 1)));
+        }
+        crc32c_table[i] = crc;
+    }
+
+#ifdef RINGBUFFER_COPY_X86
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        copy_kernel = copy_avx512;
+        copy_isa = "avx512";
+    }
+    else if (__builtin_cpu_supports("avx2"))
+    {
+        copy_kernel = copy_avx2;
+        copy_isa = "avx2";
+    }
+    else if (__builtin_cpu_supports("sse2"))
+    {
+        copy_kernel = copy_sse2;
+        copy_isa = "sse2";
+    }
+
+    if (__builtin_cpu_supports("sse4.2"))
+    {
+        crc_kernel = crc32c_sse42;
+    }
+#endif
+}
+
+void ringbuffer_copy_large(void *dst, const void *src, size_t length)
+{
+    copy_kernel((uint8_t *)dst, (const uint8_t *)src, length);
+}
+
+uint32_t ringbuffer_crc32c(uint32_t crc, const void *data, size_t length)
+{
+    return ~crc_kernel(~crc, nullptr, (const uint8_t *)data, length);
+}
+
+uint32_t ringbuffer_copy_crc32c(void *dst, const void *src, size_t length, uint32_t crc)
+{
+    return ~crc_kernel(~crc, (uint8_t *)dst, (const uint8_t *)src, length);
+}
+
+uint32_t ringbuffer_get_checksummed(ringbuffer *rb, uint8_t *data, uint32_t length, uint32_t *crc)
+{
+    assert(rb != nullptr);
+
+    struct iovec iov[2];
+    int count = ringbuffer_peek_regions(rb, iov);
+    uint32_t done = 0;
+
+    for (int i = 0; i < count && done < length; ++i)
+    {
+        uint32_t part = (uint32_t)MIN((size_t)(length - done), iov[i].iov_len);
+
+        *crc = ringbuffer_copy_crc32c(&data[done], iov[i].iov_base, part, *crc);
+        done += part;
+    }
+
+    return ringbuffer_consume(rb, done);
+}
+
+const char *ringbuffer_copy_isa(void)
+{
+    return copy_isa;
+}
@@ -0,0 +1,85 @@
+#ifndef __RINGBUFFER_COPY_H__
+#define __RINGBUFFER_COPY_H__
+
+#include "RingBuffer.h"
+
+#define RINGBUFFER_COPY_SIMD_THRESHOLD  512                 //小于该长度直接使用 memcpy
+#define RINGBUFFER_COPY_NT_THRESHOLD    (1024 * 1024)       //不小于该长度使用非临时存储，不污染cache
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+/*@brief 批量拷贝，运行时按CPU选择 AVX-512 / AVX2 / SSE2 实现
+/*
+/* 超过 RINGBUFFER_COPY_NT_THRESHOLD 的拷贝使用非临时存储，目的数据不会立刻被读取时更快
+/*
+/*@param dst 目的地址
+/*@param src 源地址
+/*@param length 长度
+*/
+void ringbuffer_copy_large(void *dst, const void *src, size_t length);
+
+/**
+/*@brief 计算CRC32C，支持SSE4.2时使用crc32指令
+/*
+/* 与 zlib crc32 的约定相同：首次传入0，之后传入上一次的返回值可以分段计算
+/*
+/*@param crc 上一段的CRC
+/*@param data 数据指针
+/*@param length 数据长度
+/*@return uint32_t CRC32C
+*/
+uint32_t ringbuffer_crc32c(uint32_t crc, const void *data, size_t length);
+
+/**
+/*@brief 拷贝的同时计算CRC32C，数据只被读取一次
+/*
+/*@param dst 目的地址
+/*@param src 源地址
+/*@param length 长度
+/*@param crc 上一段的CRC
+/*@return uint32_t 包含本段数据的CRC32C
+*/
+uint32_t ringbuffer_copy_crc32c(void *dst, const void *src, size_t length, uint32_t crc);
+
+/**
+/*@brief 从ringbuffer读取数据并在拷贝过程中计算CRC32C
+/*
+/*@param rb ringbuffer指针
+/*@param data 数据指针
+/*@param length 数据长度
+/*@param crc 输入上一段的CRC，输出包含本次读取数据的CRC
+/*@return uint32_t 实际读取长度
+*/
+uint32_t ringbuffer_get_checksummed(ringbuffer *rb, uint8_t *data, uint32_t length, uint32_t *crc);
+
+/**
+/*@brief 当前选用的拷贝实现名称
+/*
+/*@return const char* "avx512" / "avx2" / "sse2" / "memcpy"
+*/
+const char* ringbuffer_copy_isa(void);
+
+/**
+/*@brief ringbuffer内部使用的拷贝，小块直接 memcpy，大块走SIMD实现
+/*
+*/
+static inline void ringbuffer_copy(void *dst, const void *src, size_t length)
+{
+    if (length < RINGBUFFER_COPY_SIMD_THRESHOLD)
+    {
+        memcpy(dst, src, length);
+    }
+    else
+    {
+        ringbuffer_copy_large(dst, src, length);
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RINGBUFFER_COPY_H__ */
@@ -0,0 +1,59 @@
+#ifndef __RINGBUFFER_INTERNAL_H__
+#define __RINGBUFFER_INTERNAL_H__
+
+#include <time.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "RingBuffer.h"
+
+/**
+/*@brief ringbuffer 各实现共用的内部工具，不对外安装
+/*
+/* 读写位置的取值范围为 [0, 2 * size)，高半区相当于 mirror 位，
+/* ringbuffer_spsc 和共享内存 ringbuffer_shm 都用这套位置计算和futex等待/唤醒。
+*/
+
+#define load_relaxed(p)     __atomic_load_n(p, __ATOMIC_RELAXED)
+#define load_acquire(p)     __atomic_load_n(p, __ATOMIC_ACQUIRE)
+
+// 位置 [0, 2 * size) 之间两个位置的距离
+static inline uint32_t ringbuffer_pos_distance(uint32_t size, uint32_t from, uint32_t to)
+{
+    return to >= from ? to - from : 2 * size - (from - to);
+}
+
+// 位置前进 length，length 不超过 size
+static inline uint32_t ringbuffer_pos_advance(uint32_t size, uint32_t pos, uint32_t length)
+{
+    pos += length;
+    return pos >= 2 * size ? pos - 2 * size : pos;
+}
+
+// 位置对应的缓存区下标
+static inline uint32_t ringbuffer_pos_index(uint32_t size, uint32_t pos)
+{
+    return pos >= size ? pos - size : pos;
+}
+
+static inline void cpu_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// shared 为 true 时用于共享内存上的进程间等待，不能使用 FUTEX_PRIVATE_FLAG
+static inline void futex_wait(uint32_t *addr, uint32_t expect, const struct timespec *timeout, bool shared)
+{
+    syscall(SYS_futex, addr, shared ? FUTEX_WAIT : FUTEX_WAIT_PRIVATE, expect, timeout, nullptr, 0);
+}
+
+static inline void futex_wake(uint32_t *addr, bool shared)
+{
+    syscall(SYS_futex, addr, shared ? FUTEX_WAKE : FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+}
+
+#endif /* __RINGBUFFER_INTERNAL_H__ */
@@ -0,0 +1,112 @@
+#include "RingBufferIo.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// 把区域数组截断到 max 字节，max 为0时返回0个区域，调用方不再发起系统调用
+static int ringbuffer_iov_limit(struct iovec *iov, int count, uint32_t max)
+{
+    if (max == 0)
+    {
+        return 0;
+    }
+    if (count > 0 && iov[0].iov_len >= max)
+    {
+        iov[0].iov_len = max;
+        return 1;
+    }
+    if (count > 1 && iov[0].iov_len + iov[1].iov_len > max)
+    {
+        iov[1].iov_len = max - iov[0].iov_len;
+    }
+    return count;
+}
+
+int ringbuffer_free_regions(ringbuffer *rb, struct iovec iov[2])
+{
+    assert(rb != nullptr);
+
+    uint32_t available_len = ringbuffer_available_len(rb);
+
+    if (available_len == 0)
+    {
+        return 0;
+    }
+
+    iov[0].iov_base = &rb->buffer[rb->write_index];
+
+    if ((rb->flags & RINGBUFFER_FLAG_MIRRORED) || rb->buffer_size - rb->write_index >= available_len)
+    {
+        iov[0].iov_len = available_len;
+        return 1;
+    }
+
+    iov[0].iov_len = rb->buffer_size - rb->write_index;
+    iov[1].iov_base = &rb->buffer[0];
+    iov[1].iov_len = available_len - iov[0].iov_len;
+
+    return 2;
+}
+
+ssize_t ringbuffer_read_fd(ringbuffer *rb, int fd, uint32_t max)
+{
+    assert(rb != nullptr);
+
+    struct iovec iov[2];
+    int count = ringbuffer_iov_limit(iov, ringbuffer_free_regions(rb, iov), max);
+
+    if (count == 0)
+    {
+        errno = ENOBUFS;
+        return -1;
+    }
+
+    ssize_t ret = readv(fd, iov, count);
+    if (ret > 0)
+    {
+        ringbuffer_commit(rb, (uint32_t)ret);
+    }
+    return ret;
+}
+
+ssize_t ringbuffer_write_fd(ringbuffer *rb, int fd, uint32_t max)
+{
+    assert(rb != nullptr);
+
+    struct iovec iov[2];
+    int count = ringbuffer_iov_limit(iov, ringbuffer_peek_regions(rb, iov), max);
+
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    ssize_t ret = writev(fd, iov, count);
+    if (ret > 0)
+    {
+        ringbuffer_consume(rb, (uint32_t)ret);
+    }
+    return ret;
+}
+
+ssize_t ringbuffer_splice_from_pipe(ringbuffer *rb, int pipe_fd, uint32_t max)
+{
+    assert(rb != nullptr);
+
+    struct iovec iov[2];
+    int count = ringbuffer_iov_limit(iov, ringbuffer_free_regions(rb, iov), max);
+
+    if (count == 0)
+    {
+        errno = ENOBUFS;
+        return -1;
+    }
+
+    // 对管道读端 vmsplice，内核直接把管道页中的数据拷贝到ringbuffer
+    ssize_t ret = vmsplice(pipe_fd, iov, count, SPLICE_F_NONBLOCK);
+    if (ret > 0)
+    {
+        ringbuffer_commit(rb, (uint32_t)ret);
+    }
+    return ret;
+}
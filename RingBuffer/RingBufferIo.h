@@ -0,0 +1,54 @@
+#ifndef __RINGBUFFER_IO_H__
+#define __RINGBUFFER_IO_H__
+
+#include <sys/types.h>
+#include "RingBuffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+/*@brief 获取全部可写空间所在的区域，不移动写位置
+/*
+/*@param rb ringbuffer指针
+/*@param iov 输出的区域数组，至少2个元素
+/*@return int 有效区域个数 0~2
+ */
+int ringbuffer_free_regions(ringbuffer *rb, struct iovec iov[2]);
+
+/**
+/*@brief 从fd读取数据直接写入ringbuffer，一次readv覆盖全部可写区域
+/*
+/*@param rb ringbuffer指针
+/*@param fd 文件描述符，可以是非阻塞的
+/*@param max 最多读取的字节数
+/*@return ssize_t 读取的字节数，0表示EOF，-1表示出错(errno)，ringbuffer已满或 max 为0时 errno 为 ENOBUFS
+ */
+ssize_t ringbuffer_read_fd(ringbuffer *rb, int fd, uint32_t max);
+
+/**
+/*@brief 将ringbuffer中的数据写到fd，一次writev覆盖全部可读区域
+/*
+/*@param rb ringbuffer指针
+/*@param fd 文件描述符，可以是非阻塞的
+/*@param max 最多写出的字节数
+/*@return ssize_t 写出的字节数，-1表示出错(errno)，ringbuffer为空或 max 为0时返回0
+ */
+ssize_t ringbuffer_write_fd(ringbuffer *rb, int fd, uint32_t max);
+
+/**
+/*@brief 用vmsplice从管道读端把数据搬进ringbuffer
+/*
+/*@param rb ringbuffer指针
+/*@param pipe_fd 管道读端
+/*@param max 最多读取的字节数
+/*@return ssize_t 读取的字节数，-1表示出错(errno)，ringbuffer已满或 max 为0时 errno 为 ENOBUFS
+ */
+ssize_t ringbuffer_splice_from_pipe(ringbuffer *rb, int pipe_fd, uint32_t max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RINGBUFFER_IO_H__ */
@@ -0,0 +1,129 @@
+#include "RingBufferLatest.h"
+
+static inline ringbuffer_latest_slot *latest_slot(ringbuffer_latest *rb, uint64_t sequence)
+{
+    return (ringbuffer_latest_slot *)&rb->slots[(sequence & rb->mask) * rb->slot_stride];
+}
+
+ringbuffer_latest *ringbuffer_latest_create(uint32_t slot_count, uint32_t record_size)
+{
+    ringbuffer_latest *rb = nullptr;
+    uint8_t *pool = nullptr;
+    uint32_t stride = ALIGN(sizeof(ringbuffer_latest_slot) + record_size, DEFAULT_ALIGN_SIZE);
+
+    assert(slot_count > 0 && slot_count <= (1u << 31) && record_size > 0);
+
+    slot_count = slot_count <= 1 ? 1 : 1u << (32 - __builtin_clz(slot_count - 1));
+
+    if (posix_memalign((void **)&rb, RINGBUFFER_CACHELINE_SIZE, sizeof(ringbuffer_latest)) != 0)
+    {
+        rb = nullptr;
+        goto exit;
+    }
+
+    if (posix_memalign((void **)&pool, RINGBUFFER_CACHELINE_SIZE, (size_t)slot_count * stride) != 0)
+    {
+        free(rb);
+        rb = nullptr;
+        goto exit;
+    }
+
+    memset(pool, 0, (size_t)slot_count * stride);
+
+    rb->head = 0;
+    rb->mask = slot_count - 1;
+    rb->record_size = record_size;
+    rb->slot_stride = stride;
+    rb->slots = pool;
+
+exit:
+    return rb;
+}
+
+void ringbuffer_latest_destroy(ringbuffer_latest *rb)
+{
+    assert(rb != nullptr);
+
+    free(rb->slots);
+    free(rb);
+}
+
+uint64_t ringbuffer_latest_put(ringbuffer_latest *rb, const void *data, uint32_t length)
+{
+    assert(rb != nullptr);
+
+    uint64_t sequence = rb->head;
+    ringbuffer_latest_slot *slot = latest_slot(rb, sequence);
+
+    length = MIN(length, rb->record_size);
+
+    // 序号置为奇数，读者看到奇数或序号变化就知道槽位正在被改写
+    __atomic_store_n(&slot->seq, 2 * sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    slot->length = length;
+    memcpy(slot + 1, data, length);
+
+    __atomic_store_n(&slot->seq, 2 * (sequence + 1), __ATOMIC_RELEASE);
+    __atomic_store_n(&rb->head, sequence + 1, __ATOMIC_RELEASE);
+
+    return sequence;
+}
+
+int ringbuffer_latest_read(ringbuffer_latest *rb, uint64_t sequence, void *data)
+{
+    assert(rb != nullptr);
+
+    ringbuffer_latest_slot *slot = latest_slot(rb, sequence);
+    uint64_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+
+    if (seq != 2 * (sequence + 1))
+    {
+        return -1;
+    }
+
+    uint32_t length = MIN(slot->length, rb->record_size);
+    memcpy(data, slot + 1, length);
+
+    // 拷贝完成后序号没变，说明拷贝期间写者没有碰过这个槽位
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) != seq)
+    {
+        return -1;
+    }
+
+    return (int)length;
+}
+
+uint32_t ringbuffer_latest_snapshot(ringbuffer_latest *rb, void *data, uint32_t *lengths, uint32_t count, uint64_t *first)
+{
+    assert(rb != nullptr);
+
+    uint64_t head = ringbuffer_latest_count(rb);
+    uint64_t window = MIN((uint64_t)count, rb->mask + 1);
+    uint64_t start = head > window ? head - window : 0;
+    uint32_t got = 0;
+
+    if (first != nullptr)
+    {
+        *first = head;
+    }
+
+    for (uint64_t sequence = start; sequence < head; ++sequence)
+    {
+        int length = ringbuffer_latest_read(rb, sequence, (uint8_t *)data + (size_t)got * rb->record_size);
+
+        if (length < 0)     //最旧的几条在读取期间被覆盖
+        {
+            continue;
+        }
+
+        if (got == 0 && first != nullptr)
+        {
+            *first = sequence;
+        }
+        lengths[got++] = (uint32_t)length;
+    }
+
+    return got;
+}
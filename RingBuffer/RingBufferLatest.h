@@ -0,0 +1,93 @@
+#ifndef __RINGBUFFER_LATEST_H__
+#define __RINGBUFFER_LATEST_H__
+
+#include "RingBufferSpsc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+/*@brief "最近N条记录" 覆盖式ringbuffer，用于常驻的遥测/飞行记录
+/*
+/* 记录保存在固定大小的槽位中，每个槽位带一个 seqlock 序号：
+/* 写入前序号置为奇数，写完后置为 2 * (记录序号 + 1)。
+/* 写者从不等待读者，永远覆盖最旧的槽位；读者拷贝槽位后重新检查序号，
+/* 序号变化或不是期望的记录说明被覆盖，丢弃该条，所以读者拿到的每条记录都是完整的。
+/* 只允许一个写者，读者数量不限。
+*/
+typedef struct ringbuffer_latest_slot_t
+{
+    uint64_t seq;       //seqlock序号
+    uint32_t length;    //记录长度
+    uint32_t reserved;
+} ringbuffer_latest_slot;
+
+typedef struct ringbuffer_latest_t
+{
+    uint64_t head __cacheline_aligned;  //下一条记录的序号，也是已写入的记录总数
+
+    uint64_t mask __cacheline_aligned;  //槽位数量 - 1
+    uint32_t record_size;               //单条记录最大长度
+    uint32_t slot_stride;               //槽位间距
+    uint8_t *slots;
+} ringbuffer_latest;
+
+/**
+/*@brief 创建覆盖式ringbuffer
+/*
+/*@param slot_count 槽位数量，向上取整到2的幂
+/*@param record_size 单条记录最大长度
+/*@return ringbuffer_latest*
+*/
+ringbuffer_latest* ringbuffer_latest_create(uint32_t slot_count, uint32_t record_size);
+
+/**
+/*@brief 销毁覆盖式ringbuffer
+/*
+/*@param rb ringbuffer指针
+ */
+void ringbuffer_latest_destroy(ringbuffer_latest *rb);
+
+/**
+/*@brief 写入一条记录，无等待，覆盖最旧的记录，只能由一个线程调用
+/*
+/*@param rb ringbuffer指针
+/*@param data 记录指针
+/*@param length 记录长度，超过 record_size 的部分被截断
+/*@return uint64_t 记录序号
+ */
+uint64_t ringbuffer_latest_put(ringbuffer_latest *rb, const void *data, uint32_t length);
+
+/**
+/*@brief 读取指定序号的记录，可在任意线程调用
+/*
+/*@param rb ringbuffer指针
+/*@param sequence 记录序号
+/*@param data 输出缓存区，至少 record_size 字节
+/*@return int 记录长度，记录尚未写入或已被覆盖返回-1
+ */
+int ringbuffer_latest_read(ringbuffer_latest *rb, uint64_t sequence, void *data);
+
+/**
+/*@brief 获取最近的至多 count 条记录的一致快照，可在任意线程调用，写者不受影响
+/*
+/* 记录按从旧到新的顺序写入 data，每条占 record_size 字节，长度写入 lengths。
+/* 读取期间被覆盖的旧记录会被跳过，所以返回数量可能小于 count
+/*
+/*@param rb ringbuffer指针
+/*@param data 输出缓存区，至少 count * record_size 字节
+/*@param lengths 输出每条记录的长度
+/*@param count 最多读取的记录数量
+/*@param first 输出第一条返回记录的序号，可以为nullptr
+/*@return uint32_t 实际读取的记录数量
+ */
+uint32_t ringbuffer_latest_snapshot(ringbuffer_latest *rb, void *data, uint32_t *lengths, uint32_t count, uint64_t *first);
+
+#define ringbuffer_latest_count(rb) __atomic_load_n(&(rb)->head, __ATOMIC_ACQUIRE)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RINGBUFFER_LATEST_H__ */
@@ -0,0 +1,210 @@
+#include "RingBufferMem.h"
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#ifndef MPOL_BIND
+#define MPOL_BIND 2
+#endif
+
+#define RINGBUFFER_MAX_LENGTH ((1u << 31) - 1)   //读写下标只有31位
+
+#define RINGBUFFER_MMAP_FLAGS (RINGBUFFER_FLAG_ALIGN_PAGE | RINGBUFFER_FLAG_HUGEPAGE | RINGBUFFER_FLAG_THP | \
+                               RINGBUFFER_FLAG_MLOCK | RINGBUFFER_FLAG_PREFAULT)
+
+/**
+/*@brief 把同一个memfd连续映射两次
+/*
+/*@param length 缓存区大小，已按页/大页对齐
+/*@param hugetlb 是否使用hugetlbfs
+/*@return uint8_t* 失败返回nullptr
+*/
+static uint8_t *ringbuffer_mem_mirror(uint32_t length, bool hugetlb)
+{
+    uint8_t *pool = nullptr;
+    uint8_t *base = nullptr;
+    size_t reserve = 2 * (size_t)length + (hugetlb ? RINGBUFFER_HUGEPAGE_SIZE : 0);
+    int fd = memfd_create("ringbuffer", MFD_CLOEXEC | (hugetlb ? MFD_HUGETLB : 0));
+
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+
+    if (ftruncate(fd, length) != 0)
+    {
+        goto exit;
+    }
+
+    // 先占住 2 * length 的连续地址空间，再把同一个 fd 映射到前后两半。
+    // hugetlb 映射的地址必须按大页对齐，mmap 只保证按普通页对齐，多占一个大页再把首尾多余部分还回去
+    base = (uint8_t *)mmap(nullptr, reserve, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED)
+    {
+        goto exit;
+    }
+
+    pool = hugetlb ? (uint8_t *)ALIGN((uintptr_t)base, (uintptr_t)RINGBUFFER_HUGEPAGE_SIZE) : base;
+    if (pool > base)
+    {
+        munmap(base, pool - base);
+    }
+    if (base + reserve > pool + 2 * (size_t)length)
+    {
+        munmap(pool + 2 * (size_t)length, base + reserve - (pool + 2 * (size_t)length));
+    }
+
+    if (mmap(pool, length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+        mmap(pool + length, length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED)
+    {
+        munmap(pool, 2 * (size_t)length);
+        pool = nullptr;
+    }
+
+exit:
+    close(fd);
+    return pool;
+}
+
+// 把缓存区的物理页限定在 numa_node 上，必须在第一次访问之前调用，成功返回true
+static bool ringbuffer_mem_bind(uint8_t *buffer, size_t length, int numa_node)
+{
+    unsigned long nodemask[4] = {0};
+
+    if (numa_node < 0 || numa_node >= (int)(sizeof(nodemask) * 8))
+    {
+        return false;
+    }
+
+    nodemask[numa_node / (sizeof(unsigned long) * 8)] |= 1ul << (numa_node % (sizeof(unsigned long) * 8));
+    return syscall(SYS_mbind, buffer, length, MPOL_BIND, nodemask, sizeof(nodemask) * 8, 0) == 0;
+}
+
+uint8_t *ringbuffer_mem_alloc(uint32_t *length, uint32_t *flags, int numa_node)
+{
+    uint8_t *buffer = nullptr;
+    uint32_t page = (uint32_t)sysconf(_SC_PAGESIZE);
+    uint64_t size = *length;
+
+    assert(size > 0);
+
+    if (!(*flags & RINGBUFFER_FLAG_MIRRORED) && !(*flags & RINGBUFFER_MMAP_FLAGS) && numa_node < 0)
+    {
+        size_t align = (*flags & RINGBUFFER_FLAG_ALIGN_CACHELINE) ? RINGBUFFER_CACHELINE_SIZE : DEFAULT_ALIGN_SIZE;
+
+        size = ALIGN_DOWN(size, DEFAULT_ALIGN_SIZE);
+        if (size == 0 || posix_memalign((void **)&buffer, align, size) != 0)
+        {
+            return nullptr;
+        }
+        *length = (uint32_t)size;
+        return buffer;
+    }
+
+    if (*flags & RINGBUFFER_FLAG_HUGEPAGE)
+    {
+        uint64_t huge_size = ALIGN(size, (uint64_t)RINGBUFFER_HUGEPAGE_SIZE);
+
+        if (huge_size <= RINGBUFFER_MAX_LENGTH)
+        {
+            if (*flags & RINGBUFFER_FLAG_MIRRORED)
+            {
+                buffer = ringbuffer_mem_mirror((uint32_t)huge_size, true);
+            }
+            else
+            {
+                buffer = (uint8_t *)mmap(nullptr, huge_size, PROT_READ | PROT_WRITE,
+                                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+                if (buffer == MAP_FAILED)
+                {
+                    buffer = nullptr;
+                }
+            }
+        }
+
+        if (buffer != nullptr)
+        {
+            size = huge_size;
+        }
+        else
+        {
+            // 没有预留大页，退回普通页 + 透明大页
+            *flags = (*flags & ~RINGBUFFER_FLAG_HUGEPAGE) | RINGBUFFER_FLAG_THP;
+        }
+    }
+
+    if (buffer == nullptr)
+    {
+        size = ALIGN(size, (uint64_t)page);
+        if (size > RINGBUFFER_MAX_LENGTH)
+        {
+            return nullptr;
+        }
+
+        if (*flags & RINGBUFFER_FLAG_MIRRORED)
+        {
+            buffer = ringbuffer_mem_mirror((uint32_t)size, false);
+        }
+        else
+        {
+            buffer = (uint8_t *)mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (buffer == MAP_FAILED)
+            {
+                buffer = nullptr;
+            }
+        }
+
+        if (buffer == nullptr)
+        {
+            return nullptr;
+        }
+
+        if (*flags & RINGBUFFER_FLAG_THP)
+        {
+            madvise(buffer, size, MADV_HUGEPAGE);
+        }
+    }
+
+    *flags |= RINGBUFFER_FLAG_MMAPPED;
+    *length = (uint32_t)size;
+
+    // 节点不存在、没有权限或内核不支持NUMA时不绑定，通过 flags 告诉调用者
+    *flags &= ~RINGBUFFER_FLAG_NUMA_BOUND;
+    if (ringbuffer_mem_bind(buffer, size, numa_node))
+    {
+        *flags |= RINGBUFFER_FLAG_NUMA_BOUND;
+    }
+
+    // 超出 RLIMIT_MEMLOCK 时不锁定，清除标志
+    if ((*flags & RINGBUFFER_FLAG_MLOCK) && mlock(buffer, size) != 0)
+    {
+        *flags &= ~RINGBUFFER_FLAG_MLOCK;
+    }
+
+    if (*flags & RINGBUFFER_FLAG_PREFAULT)
+    {
+        // 每页写一次，让内核现在就分配物理页并建立页表
+        for (uint64_t offset = 0; offset < size; offset += page)
+        {
+            ((volatile uint8_t *)buffer)[offset] = 0;
+        }
+    }
+
+    return buffer;
+}
+
+void ringbuffer_mem_free(uint8_t *buffer, uint32_t length, uint32_t flags)
+{
+    if (buffer == nullptr)
+    {
+        return;
+    }
+
+    if (!(flags & RINGBUFFER_FLAG_MMAPPED))
+    {
+        free(buffer);
+        return;
+    }
+
+    munmap(buffer, (flags & RINGBUFFER_FLAG_MIRRORED) ? 2 * (size_t)length : length);
+}
@@ -0,0 +1,39 @@
+#ifndef __RINGBUFFER_MEM_H__
+#define __RINGBUFFER_MEM_H__
+
+#include "RingBuffer.h"
+
+#define RINGBUFFER_HUGEPAGE_SIZE (2u * 1024 * 1024)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+/*@brief 按 RINGBUFFER_FLAG_* 分配ringbuffer缓存区
+/*
+/* 需要页对齐、大页、NUMA绑定、预缺页等特性时用 mmap 分配，否则用 posix_memalign。
+/* 大页分配失败会退回普通页并改用透明大页，mlock 失败会清除 RINGBUFFER_FLAG_MLOCK，
+/* 绑定 NUMA 节点成功时设置 RINGBUFFER_FLAG_NUMA_BOUND，实际生效的标志通过 flags 返回。
+/*
+/*@param length 输入期望大小，输出实际大小
+/*@param flags 输入创建标志，输出实际生效的标志，释放时原样传给 ringbuffer_mem_free
+/*@param numa_node 绑定的NUMA节点，小于0表示不绑定
+/*@return uint8_t* 缓存区指针，失败返回nullptr
+*/
+uint8_t* ringbuffer_mem_alloc(uint32_t *length, uint32_t *flags, int numa_node);
+
+/**
+/*@brief 释放 ringbuffer_mem_alloc 分配的缓存区
+/*
+/*@param buffer 缓存区指针
+/*@param length ringbuffer_mem_alloc 输出的大小
+/*@param flags ringbuffer_mem_alloc 输出的标志
+*/
+void ringbuffer_mem_free(uint8_t *buffer, uint32_t length, uint32_t flags);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RINGBUFFER_MEM_H__ */
@@ -0,0 +1,185 @@
+#include "RingBufferMpmc.h"
+#include "RingBufferInternal.h"
+#include <sched.h>
+
+#define RINGBUFFER_MPMC_SPIN_COUNT 64
+
+// 向上取整到2的幂
+static uint64_t ringbuffer_mpmc_roundup_pow2(uint64_t length)
+{
+    return length <= 1 ? 1 : 1ull << (64 - __builtin_clzll(length - 1));
+}
+
+/**
+/*@brief 等待排在前面的预留者发布完成，再发布自己的区间
+/*
+/* 先自旋，等太久说明前一个线程可能被调度走了，改为让出CPU
+/*
+/*@param tail 发布游标
+/*@param start 本次预留的起点
+/*@param end 本次预留的终点
+*/
+static inline void ringbuffer_mpmc_publish(uint64_t *tail, uint64_t start, uint64_t end)
+{
+    uint32_t spins = 0;
+
+    while (__atomic_load_n(tail, __ATOMIC_ACQUIRE) != start)
+    {
+        if (++spins < RINGBUFFER_MPMC_SPIN_COUNT)
+        {
+            cpu_relax();
+        }
+        else
+        {
+            sched_yield();
+        }
+    }
+
+    __atomic_store_n(tail, end, __ATOMIC_RELEASE);
+}
+
+ringbuffer_mpmc *ringbuffer_mpmc_create(uint64_t length, int multi_consumer)
+{
+    ringbuffer_mpmc *rb = nullptr;
+    uint8_t *pool = nullptr;
+
+    assert(length > 0 && length <= (1ull << 63));
+
+    length = ringbuffer_mpmc_roundup_pow2(length);
+
+    if (posix_memalign((void **)&rb, RINGBUFFER_CACHELINE_SIZE, sizeof(ringbuffer_mpmc)) != 0)
+    {
+        rb = nullptr;
+        goto exit;
+    }
+
+    if (posix_memalign((void **)&pool, RINGBUFFER_CACHELINE_SIZE, length) != 0)
+    {
+        free(rb);
+        rb = nullptr;
+        goto exit;
+    }
+
+    rb->prod_head = rb->prod_tail = 0;
+    rb->cons_head = rb->cons_tail = 0;
+    rb->mask = length - 1;
+    rb->multi_consumer = multi_consumer ? 1 : 0;
+    rb->buffer = pool;
+
+exit:
+    return rb;
+}
+
+void ringbuffer_mpmc_destroy(ringbuffer_mpmc *rb)
+{
+    assert(rb != nullptr);
+
+    free(rb->buffer);
+    free(rb);
+}
+
+uint32_t ringbuffer_mpmc_put(ringbuffer_mpmc *rb, const uint8_t *data, uint32_t length)
+{
+    assert(rb != nullptr);
+
+    uint64_t size = rb->mask + 1;
+
+    if (length == 0 || length > size)
+    {
+        return 0;
+    }
+
+    uint64_t head = __atomic_load_n(&rb->prod_head, __ATOMIC_RELAXED);
+
+    do
+    {
+        // head 可能已经过期，此时 free 可能大于 size，但随后的 CAS 一定失败并重新加载
+        uint64_t free_len = size + __atomic_load_n(&rb->cons_tail, __ATOMIC_ACQUIRE) - head;
+
+        if (free_len < length)
+        {
+            return 0;
+        }
+    } while (!__atomic_compare_exchange_n(&rb->prod_head, &head, head + length, true,
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    uint64_t index = head & rb->mask;
+    uint64_t first = MIN(length, size - index);
+
+    memcpy(&rb->buffer[index], data, first);
+    if (first < length)
+    {
+        memcpy(&rb->buffer[0], &data[first], length - first);
+    }
+
+    ringbuffer_mpmc_publish(&rb->prod_tail, head, head + length);
+
+    return length;
+}
+
+uint32_t ringbuffer_mpmc_get(ringbuffer_mpmc *rb, uint8_t *data, uint32_t length)
+{
+    assert(rb != nullptr);
+
+    uint64_t size = rb->mask + 1;
+    uint64_t head = __atomic_load_n(&rb->cons_head, __ATOMIC_RELAXED);
+    uint64_t data_length = 0;
+
+    do
+    {
+        data_length = __atomic_load_n(&rb->prod_tail, __ATOMIC_ACQUIRE) - head;
+
+        if (data_length > size)     //head 已过期
+        {
+            head = __atomic_load_n(&rb->cons_head, __ATOMIC_RELAXED);
+            continue;
+        }
+
+        if (data_length == 0)
+        {
+            return 0;
+        }
+
+        if (data_length < length)
+        {
+            length = (uint32_t)data_length;
+        }
+
+        if (!rb->multi_consumer)
+        {
+            rb->cons_head = head + length;
+            break;
+        }
+    } while (data_length > size || !__atomic_compare_exchange_n(&rb->cons_head, &head, head + length, true,
+                                                                __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    uint64_t index = head & rb->mask;
+    uint64_t first = MIN(length, size - index);
+
+    memcpy(data, &rb->buffer[index], first);
+    if (first < length)
+    {
+        memcpy(&data[first], &rb->buffer[0], length - first);
+    }
+
+    if (rb->multi_consumer)
+    {
+        ringbuffer_mpmc_publish(&rb->cons_tail, head, head + length);
+    }
+    else
+    {
+        __atomic_store_n(&rb->cons_tail, head + length, __ATOMIC_RELEASE);
+    }
+
+    return length;
+}
+
+uint64_t ringbuffer_mpmc_data_len(ringbuffer_mpmc *rb)
+{
+    assert(rb != nullptr);
+
+    uint64_t cons_tail = __atomic_load_n(&rb->cons_tail, __ATOMIC_ACQUIRE);
+    uint64_t prod_tail = __atomic_load_n(&rb->prod_tail, __ATOMIC_ACQUIRE);
+
+    return prod_tail - cons_tail;
+}
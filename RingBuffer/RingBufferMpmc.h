@@ -0,0 +1,82 @@
+#ifndef __RINGBUFFER_MPMC_H__
+#define __RINGBUFFER_MPMC_H__
+
+#include "RingBufferSpsc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+/*@brief 多生产者ringbuffer，可选多消费者
+/*
+/* 每一侧都有 head(预留游标) 和 tail(发布游标) 两个64位计数，容量为2的幂。
+/* 生产者用 CAS 推进 prod_head 预留空间，各自并行拷贝数据，
+/* 然后按预留顺序等待 prod_tail 追上自己的起点后再发布，消费者只能看到 prod_tail 之前完整写入的数据。
+/* 消费者一侧对称：单消费者直接推进游标，多消费者同样先 CAS 预留再按序发布。
+*/
+typedef struct ringbuffer_mpmc_t
+{
+    uint64_t prod_head __cacheline_aligned;    //生产者预留游标
+    uint64_t prod_tail __cacheline_aligned;    //生产者发布游标，消费者可见
+    uint64_t cons_head __cacheline_aligned;    //消费者预留游标
+    uint64_t cons_tail __cacheline_aligned;    //消费者发布游标，生产者可见
+
+    uint64_t mask __cacheline_aligned;
+    uint32_t multi_consumer;                   //是否允许多个消费者
+    uint8_t *buffer;
+} ringbuffer_mpmc;
+
+/**
+/*@brief 创建多生产者ringbuffer
+/*
+/*@param length 缓存区大小，向上取整到2的幂
+/*@param multi_consumer 0: 单消费者(MPSC)  1: 多消费者(MPMC)
+/*@return ringbuffer_mpmc*
+*/
+ringbuffer_mpmc* ringbuffer_mpmc_create(uint64_t length, int multi_consumer);
+
+/**
+/*@brief 销毁ringbuffer
+/*
+/*@param rb ringbuffer指针
+ */
+void ringbuffer_mpmc_destroy(ringbuffer_mpmc *rb);
+
+/**
+/*@brief 写入数据，可在多个线程并发调用
+/*
+/* 数据要么全部写入要么不写入，保证一次写入的字节在消费者看来是连续的
+/*
+/*@param rb ringbuffer指针
+/*@param data 数据指针
+/*@param length 数据长度
+/*@return uint32_t 写入长度，空间不足返回0
+ */
+uint32_t ringbuffer_mpmc_put(ringbuffer_mpmc *rb, const uint8_t *data, uint32_t length);
+
+/**
+/*@brief 读取数据，多消费者模式下可并发调用
+/*
+/*@param rb ringbuffer指针
+/*@param data 数据指针
+/*@param length 最大读取长度
+/*@return uint32_t 实际读取长度
+ */
+uint32_t ringbuffer_mpmc_get(ringbuffer_mpmc *rb, uint8_t *data, uint32_t length);
+
+/**
+/*@brief 获取已发布的数据长度，结果只是一个快照
+/*
+/*@param rb ringbuffer指针
+/*@return uint64_t 数据长度
+ */
+uint64_t ringbuffer_mpmc_data_len(ringbuffer_mpmc *rb);
+
+#define ringbuffer_mpmc_get_size(rb) ((rb)->mask + 1)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RINGBUFFER_MPMC_H__ */
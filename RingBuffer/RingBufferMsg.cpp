@@ -0,0 +1,186 @@
+#include "RingBufferMsg.h"
+
+/**
+/*@brief 从 index 处开始查找下一条消息，跳过填充记录
+/*
+/*@param rb ringbuffer指针
+/*@param index 起始下标
+/*@param remain 起始下标之后的可读数据长度
+/*@param skip 输出被跳过的填充记录长度
+/*@return ringbuffer_msg_hdr* 消息头，没有消息返回nullptr
+*/
+static ringbuffer_msg_hdr *ringbuffer_msg_locate(ringbuffer *rb, uint32_t index, uint32_t remain, uint32_t *skip)
+{
+    *skip = 0;
+
+    while (remain >= sizeof(ringbuffer_msg_hdr))
+    {
+        ringbuffer_msg_hdr *hdr = (ringbuffer_msg_hdr *)&rb->buffer[index];
+
+        if (!(hdr->flags & RINGBUFFER_MSG_PAD))
+        {
+            return hdr;
+        }
+
+        uint32_t size = RINGBUFFER_MSG_SIZE(hdr->length);
+
+        *skip += size;
+        remain -= size;
+        index += size;
+        if (index >= rb->buffer_size)
+        {
+            index -= rb->buffer_size;
+        }
+    }
+
+    return nullptr;
+}
+
+uint32_t ringbuffer_put_msg(ringbuffer *rb, const uint8_t *data, uint32_t length)
+{
+    assert(rb != nullptr);
+
+    // 记录头加负载超过缓存区大小的消息永远写不进去
+    if (length == 0 || RINGBUFFER_MSG_SIZE((uint64_t)length) > rb->buffer_size)
+    {
+        return 0;
+    }
+
+    // 读写下标不会自己回到0，缓存区为空时主动归零，否则写位置靠近末尾时大消息加上填充永远放不下
+    if (ringbuffer_data_len(rb) == 0)
+    {
+        ringbuffer_reset(rb);
+    }
+
+    uint32_t need = RINGBUFFER_MSG_SIZE(length);
+    uint32_t pad = 0;
+    uint32_t tail = rb->buffer_size - rb->write_index;
+
+    // 镜像模式下任意位置都是连续的，不需要填充
+    if (!(rb->flags & RINGBUFFER_FLAG_MIRRORED) && tail < need)
+    {
+        pad = tail;
+    }
+
+    if ((uint64_t)need + pad > ringbuffer_available_len(rb))
+    {
+        return 0;
+    }
+
+    ringbuffer_msg_hdr *hdr = nullptr;
+
+    if (pad > 0)
+    {
+        hdr = (ringbuffer_msg_hdr *)&rb->buffer[rb->write_index];
+        hdr->length = pad - sizeof(ringbuffer_msg_hdr);
+        hdr->flags = RINGBUFFER_MSG_PAD;
+        ringbuffer_commit(rb, pad);
+    }
+
+    hdr = (ringbuffer_msg_hdr *)&rb->buffer[rb->write_index];
+    hdr->length = length;
+    hdr->flags = 0;
+    memcpy(hdr + 1, data, length);
+    ringbuffer_commit(rb, need);
+
+    return length;
+}
+
+int ringbuffer_get_msg(ringbuffer *rb, uint8_t *data, uint32_t length)
+{
+    assert(rb != nullptr);
+
+    uint8_t *ptr = nullptr;
+    uint32_t msg_length = ringbuffer_peek_msg(rb, &ptr);
+
+    if (msg_length == 0)
+    {
+        return 0;
+    }
+
+    if (msg_length > length)
+    {
+        return -1;
+    }
+
+    memcpy(data, ptr, msg_length);
+    ringbuffer_consume_msg(rb);
+
+    return (int)msg_length;
+}
+
+uint32_t ringbuffer_peek_msg(ringbuffer *rb, uint8_t **ptr)
+{
+    assert(rb != nullptr);
+
+    uint32_t skip = 0;
+    ringbuffer_msg_hdr *hdr = ringbuffer_msg_locate(rb, rb->read_index, ringbuffer_data_len(rb), &skip);
+
+    if (hdr == nullptr)
+    {
+        *ptr = nullptr;
+        return 0;
+    }
+
+    *ptr = (uint8_t *)(hdr + 1);
+
+    return hdr->length;
+}
+
+uint32_t ringbuffer_consume_msg(ringbuffer *rb)
+{
+    assert(rb != nullptr);
+
+    uint32_t skip = 0;
+    ringbuffer_msg_hdr *hdr = ringbuffer_msg_locate(rb, rb->read_index, ringbuffer_data_len(rb), &skip);
+
+    if (hdr == nullptr)
+    {
+        ringbuffer_consume(rb, skip);
+        return 0;
+    }
+
+    uint32_t length = hdr->length;
+
+    ringbuffer_consume(rb, skip + RINGBUFFER_MSG_SIZE(length));
+
+    return length;
+}
+
+uint32_t ringbuffer_peek_msg_batch(ringbuffer *rb, struct iovec *msgs, uint32_t max_count, uint32_t *span)
+{
+    assert(rb != nullptr);
+
+    uint32_t count = 0;
+    uint32_t index = rb->read_index;
+    uint32_t remain = ringbuffer_data_len(rb);
+    uint32_t skip = 0;
+
+    *span = 0;
+
+    while (count < max_count)
+    {
+        ringbuffer_msg_hdr *hdr = ringbuffer_msg_locate(rb, index, remain, &skip);
+
+        if (hdr == nullptr)
+        {
+            break;
+        }
+
+        uint32_t size = skip + RINGBUFFER_MSG_SIZE(hdr->length);
+
+        msgs[count].iov_base = hdr + 1;
+        msgs[count].iov_len = hdr->length;
+        ++count;
+
+        *span += size;
+        remain -= size;
+        index = (uint32_t)((uint8_t *)hdr - rb->buffer) + RINGBUFFER_MSG_SIZE(hdr->length);
+        if (index >= rb->buffer_size)
+        {
+            index -= rb->buffer_size;
+        }
+    }
+
+    return count;
+}
@@ -0,0 +1,82 @@
+#ifndef __RINGBUFFER_MSG_H__
+#define __RINGBUFFER_MSG_H__
+
+#include "RingBuffer.h"
+
+#define RINGBUFFER_MSG_ALIGN    DEFAULT_ALIGN_SIZE
+#define RINGBUFFER_MSG_PAD      (1u << 0)   //填充记录，表示缓存区剩余部分无数据
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+/*@brief 消息记录头
+/*
+/* 每条记录由记录头和负载组成，整体对齐到 RINGBUFFER_MSG_ALIGN。
+/* 末尾剩余空间放不下一整条记录时写入一个填充记录并回绕，所以一条消息在缓存区内总是连续的。
+/* 同一个 ringbuffer 不能混用消息接口和字节流接口。
+*/
+typedef struct ringbuffer_msg_hdr_t
+{
+    uint32_t length;    //负载长度
+    uint32_t flags;     //记录标志
+} ringbuffer_msg_hdr;
+
+#define RINGBUFFER_MSG_SIZE(len) ALIGN(sizeof(ringbuffer_msg_hdr) + (len), RINGBUFFER_MSG_ALIGN)
+
+/**
+/*@brief 写入一条消息
+/*
+/*@param rb ringbuffer指针
+/*@param data 消息指针
+/*@param length 消息长度，必须大于0，且 RINGBUFFER_MSG_SIZE(length) 不能超过缓存区大小
+/*@return uint32_t 写入的消息长度，空间不足或消息超过上述上限时为0
+ */
+uint32_t ringbuffer_put_msg(ringbuffer *rb, const uint8_t *data, uint32_t length);
+
+/**
+/*@brief 读取一条消息
+/*
+/*@param rb ringbuffer指针
+/*@param data 数据指针
+/*@param length 数据缓存区长度
+/*@return int 消息长度，没有消息返回0，缓存区太小返回-1且消息保留在ringbuffer中
+ */
+int ringbuffer_get_msg(ringbuffer *rb, uint8_t *data, uint32_t length);
+
+/**
+/*@brief 查看下一条消息，不移动读位置
+/*
+/*@param rb ringbuffer指针
+/*@param ptr 消息在ringbuffer内的地址
+/*@return uint32_t 消息长度，没有消息返回0
+ */
+uint32_t ringbuffer_peek_msg(ringbuffer *rb, uint8_t **ptr);
+
+/**
+/*@brief 丢弃下一条消息，与 ringbuffer_peek_msg 配合使用
+/*
+/*@param rb ringbuffer指针
+/*@return uint32_t 丢弃的消息长度，没有消息返回0
+ */
+uint32_t ringbuffer_consume_msg(ringbuffer *rb);
+
+/**
+/*@brief 批量查看消息，不移动读位置
+/*
+/* 返回的消息都指向ringbuffer内部，处理完后调用 ringbuffer_consume(rb, *span) 一次性释放
+/*
+/*@param rb ringbuffer指针
+/*@param msgs 输出的消息数组
+/*@param max_count 最多查看的消息数量
+/*@param span 输出这些消息在ringbuffer中占用的总字节数
+/*@return uint32_t 消息数量
+ */
+uint32_t ringbuffer_peek_msg_batch(ringbuffer *rb, struct iovec *msgs, uint32_t max_count, uint32_t *span);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RINGBUFFER_MSG_H__ */
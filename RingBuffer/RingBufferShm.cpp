@@ -0,0 +1,376 @@
+#include "RingBufferShm.h"
+#include "RingBufferInternal.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define RINGBUFFER_SHM_SLICE_MS 100     //阻塞等待时检查对端存活的间隔
+
+static inline int process_alive(int32_t pid)
+{
+    return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+}
+
+/**
+/*@brief 映射共享内存并占用 role 角色
+/*
+/*@param fd 共享内存fd
+/*@param role 角色
+/*@param init 新建时传入数据区大小，连接时传0
+/*@return ringbuffer_shm* 
+*/
+static ringbuffer_shm *ringbuffer_shm_map(int fd, int role, uint32_t init)
+{
+    ringbuffer_shm *rb = nullptr;
+    ringbuffer_shm_hdr *hdr = nullptr;
+    uint32_t data_offset = ALIGN(sizeof(ringbuffer_shm_hdr), RINGBUFFER_CACHELINE_SIZE);
+    size_t map_size = 0;
+    int32_t pid = 0;
+
+    if (init > 0)
+    {
+        map_size = data_offset + (size_t)init;
+        if (ftruncate(fd, map_size) != 0)
+        {
+            return nullptr;
+        }
+    }
+    else
+    {
+        struct stat st;
+        if (fstat(fd, &st) != 0)
+        {
+            return nullptr;
+        }
+        map_size = st.st_size;
+        if (map_size < data_offset)
+        {
+            errno = EINVAL;
+            return nullptr;
+        }
+    }
+
+    hdr = (ringbuffer_shm_hdr *)mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (hdr == MAP_FAILED)
+    {
+        return nullptr;
+    }
+
+    if (init > 0)
+    {
+        hdr->buffer_size = init;
+        hdr->data_offset = data_offset;
+        __atomic_store_n(&hdr->magic, RINGBUFFER_SHM_MAGIC, __ATOMIC_RELEASE);
+    }
+    else if (load_acquire(&hdr->magic) != RINGBUFFER_SHM_MAGIC ||
+             (size_t)hdr->data_offset + hdr->buffer_size > map_size)
+    {
+        errno = EINVAL;
+        goto fail;
+    }
+
+    // 抢占角色：未连接或原进程已不存在时接管
+    pid = load_acquire(&hdr->pid[role]);
+    do
+    {
+        if (process_alive(pid))
+        {
+            errno = EBUSY;
+            goto fail;
+        }
+    } while (!__atomic_compare_exchange_n(&hdr->pid[role], &pid, (int32_t)getpid(), false,
+                                          __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+    __atomic_store_n(&hdr->attached[role], 1, __ATOMIC_RELEASE);
+
+    // 清除崩溃进程遗留的等待登记
+    __atomic_store_n(role == RINGBUFFER_SHM_PRODUCER ? &hdr->prod_need : &hdr->cons_need, 0, __ATOMIC_SEQ_CST);
+
+    rb = (ringbuffer_shm *)malloc(sizeof(ringbuffer_shm));
+    if (rb == nullptr)
+    {
+        __atomic_store_n(&hdr->pid[role], 0, __ATOMIC_RELEASE);
+        goto fail;
+    }
+
+    rb->hdr = hdr;
+    rb->buffer = (uint8_t *)hdr + hdr->data_offset;
+    rb->map_size = map_size;
+    rb->role = role;
+    rb->peer_pos_cache = role == RINGBUFFER_SHM_PRODUCER ? load_acquire(&hdr->read_pos)
+                                                        : load_acquire(&hdr->write_pos);
+    return rb;
+
+fail:
+    munmap(hdr, map_size);
+    return nullptr;
+}
+
+ringbuffer_shm *ringbuffer_shm_create(const char *name, uint32_t length, int role)
+{
+    assert(name != nullptr);
+    assert(role == RINGBUFFER_SHM_PRODUCER || role == RINGBUFFER_SHM_CONSUMER);
+
+    length = ALIGN_DOWN(length, DEFAULT_ALIGN_SIZE);
+    if (length == 0 || length > UINT32_MAX / 2)
+    {
+        errno = EINVAL;
+        return nullptr;
+    }
+
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+
+    ringbuffer_shm *rb = ringbuffer_shm_map(fd, role, length);
+    if (rb == nullptr)
+    {
+        int err = errno;
+        shm_unlink(name);
+        errno = err;
+    }
+
+    close(fd);
+    return rb;
+}
+
+ringbuffer_shm *ringbuffer_shm_attach(const char *name, int role)
+{
+    assert(name != nullptr);
+    assert(role == RINGBUFFER_SHM_PRODUCER || role == RINGBUFFER_SHM_CONSUMER);
+
+    int fd = shm_open(name, O_RDWR, 0600);
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+
+    ringbuffer_shm *rb = ringbuffer_shm_map(fd, role, 0);
+
+    close(fd);
+    return rb;
+}
+
+void ringbuffer_shm_detach(ringbuffer_shm *rb)
+{
+    assert(rb != nullptr);
+
+    __atomic_store_n(&rb->hdr->pid[rb->role], 0, __ATOMIC_RELEASE);
+
+    // 唤醒可能在等待本进程的对端，让它重新检查连接状态
+    futex_wake(rb->role == RINGBUFFER_SHM_PRODUCER ? &rb->hdr->write_pos : &rb->hdr->read_pos, true);
+
+    munmap(rb->hdr, rb->map_size);
+    free(rb);
+}
+
+int ringbuffer_shm_unlink(const char *name)
+{
+    return shm_unlink(name);
+}
+
+uint32_t ringbuffer_shm_put(ringbuffer_shm *rb, const uint8_t *data, uint32_t length)
+{
+    assert(rb != nullptr && rb->role == RINGBUFFER_SHM_PRODUCER);
+
+    ringbuffer_shm_hdr *hdr = rb->hdr;
+    uint32_t write_pos = load_relaxed(&hdr->write_pos);
+    uint32_t available_len = hdr->buffer_size - ringbuffer_pos_distance(hdr->buffer_size, rb->peer_pos_cache, write_pos);
+
+    if (available_len < length)
+    {
+        rb->peer_pos_cache = load_acquire(&hdr->read_pos);
+        available_len = hdr->buffer_size - ringbuffer_pos_distance(hdr->buffer_size, rb->peer_pos_cache, write_pos);
+    }
+
+    length = MIN(length, available_len);
+    if (length == 0)
+    {
+        return 0;
+    }
+
+    uint32_t write_index = ringbuffer_pos_index(hdr->buffer_size, write_pos);
+    uint32_t first = MIN(length, hdr->buffer_size - write_index);
+
+    memcpy(&rb->buffer[write_index], data, first);
+    if (first < length)
+    {
+        memcpy(&rb->buffer[0], &data[first], length - first);
+    }
+
+    write_pos = ringbuffer_pos_advance(hdr->buffer_size, write_pos, length);
+    __atomic_store_n(&hdr->write_pos, write_pos, __ATOMIC_SEQ_CST);
+
+    uint32_t need = __atomic_load_n(&hdr->cons_need, __ATOMIC_SEQ_CST);
+    if (need != 0 && ringbuffer_pos_distance(hdr->buffer_size, load_acquire(&hdr->read_pos), write_pos) >= need)
+    {
+        futex_wake(&hdr->write_pos, true);
+    }
+
+    return length;
+}
+
+uint32_t ringbuffer_shm_get(ringbuffer_shm *rb, uint8_t *data, uint32_t length)
+{
+    assert(rb != nullptr && rb->role == RINGBUFFER_SHM_CONSUMER);
+
+    ringbuffer_shm_hdr *hdr = rb->hdr;
+    uint32_t read_pos = load_relaxed(&hdr->read_pos);
+    uint32_t data_length = ringbuffer_pos_distance(hdr->buffer_size, read_pos, rb->peer_pos_cache);
+
+    if (data_length < length)
+    {
+        rb->peer_pos_cache = load_acquire(&hdr->write_pos);
+        data_length = ringbuffer_pos_distance(hdr->buffer_size, read_pos, rb->peer_pos_cache);
+    }
+
+    length = MIN(length, data_length);
+    if (length == 0)
+    {
+        return 0;
+    }
+
+    uint32_t read_index = ringbuffer_pos_index(hdr->buffer_size, read_pos);
+    uint32_t first = MIN(length, hdr->buffer_size - read_index);
+
+    memcpy(data, &rb->buffer[read_index], first);
+    if (first < length)
+    {
+        memcpy(&data[first], &rb->buffer[0], length - first);
+    }
+
+    read_pos = ringbuffer_pos_advance(hdr->buffer_size, read_pos, length);
+    __atomic_store_n(&hdr->read_pos, read_pos, __ATOMIC_SEQ_CST);
+
+    uint32_t need = __atomic_load_n(&hdr->prod_need, __ATOMIC_SEQ_CST);
+    if (need != 0 && hdr->buffer_size - ringbuffer_pos_distance(hdr->buffer_size, read_pos, load_acquire(&hdr->write_pos)) >= need)
+    {
+        futex_wake(&hdr->read_pos, true);
+    }
+
+    return length;
+}
+
+/**
+/*@brief 等待空闲空间(生产者)或数据(消费者)达到 need
+/*
+/* 按 RINGBUFFER_SHM_SLICE_MS 分段休眠，每段醒来检查对端是否崩溃。
+/* 对端还没有连接过时继续等待，连接过又断开(pid 已清0)时和崩溃一样返回
+/*
+/*@param rb ringbuffer指针
+/*@param need 需要的长度
+/*@param timeout_ms 超时时间(毫秒)，小于0表示一直等待
+/*@return bool false 表示超时或对端已断开、已退出
+*/
+static bool ringbuffer_shm_wait(ringbuffer_shm *rb, uint32_t need, int timeout_ms)
+{
+    ringbuffer_shm_hdr *hdr = rb->hdr;
+    bool producer = rb->role == RINGBUFFER_SHM_PRODUCER;
+    uint32_t *need_ptr = producer ? &hdr->prod_need : &hdr->cons_need;
+    uint32_t *peer_pos = producer ? &hdr->read_pos : &hdr->write_pos;
+    struct timespec start, now;
+    bool ready = false;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    __atomic_store_n(need_ptr, need, __ATOMIC_SEQ_CST);
+
+    while (true)
+    {
+        uint32_t pos = __atomic_load_n(peer_pos, __ATOMIC_SEQ_CST);
+        uint32_t len = producer ? hdr->buffer_size - ringbuffer_pos_distance(hdr->buffer_size, pos, hdr->write_pos)
+                                : ringbuffer_pos_distance(hdr->buffer_size, hdr->read_pos, pos);
+
+        if (len >= need)
+        {
+            ready = true;
+            break;
+        }
+
+        int peer_role = producer ? RINGBUFFER_SHM_CONSUMER : RINGBUFFER_SHM_PRODUCER;
+        int32_t peer = load_acquire(&hdr->pid[peer_role]);
+        if (peer != 0 ? !process_alive(peer) : load_acquire(&hdr->attached[peer_role]) != 0)
+        {
+            break;
+        }
+
+        long slice_ms = RINGBUFFER_SHM_SLICE_MS;
+        if (timeout_ms >= 0)
+        {
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            long elapsed_ms = (now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000;
+            if (elapsed_ms >= timeout_ms)
+            {
+                break;
+            }
+            slice_ms = MIN(slice_ms, timeout_ms - elapsed_ms);
+        }
+
+        struct timespec timeout = { slice_ms / 1000, (slice_ms % 1000) * 1000000L };
+        futex_wait(peer_pos, pos, &timeout, true);
+    }
+
+    __atomic_store_n(need_ptr, 0, __ATOMIC_RELAXED);
+
+    return ready;
+}
+
+uint32_t ringbuffer_shm_put_wait(ringbuffer_shm *rb, const uint8_t *data, uint32_t length, int timeout_ms)
+{
+    assert(rb != nullptr && rb->role == RINGBUFFER_SHM_PRODUCER);
+
+    uint32_t done = 0;
+
+    while (true)
+    {
+        done += ringbuffer_shm_put(rb, &data[done], length - done);
+        if (done == length)
+        {
+            break;
+        }
+
+        if (!ringbuffer_shm_wait(rb, MIN(length - done, rb->hdr->buffer_size), timeout_ms))
+        {
+            done += ringbuffer_shm_put(rb, &data[done], length - done);
+            break;
+        }
+    }
+
+    return done;
+}
+
+uint32_t ringbuffer_shm_get_wait(ringbuffer_shm *rb, uint8_t *data, uint32_t length, int timeout_ms)
+{
+    assert(rb != nullptr && rb->role == RINGBUFFER_SHM_CONSUMER);
+
+    uint32_t got = ringbuffer_shm_get(rb, data, length);
+
+    if (got == 0 && length > 0 && ringbuffer_shm_wait(rb, 1, timeout_ms))
+    {
+        got = ringbuffer_shm_get(rb, data, length);
+    }
+
+    return got;
+}
+
+int ringbuffer_shm_peer_alive(ringbuffer_shm *rb)
+{
+    assert(rb != nullptr);
+
+    int peer = rb->role == RINGBUFFER_SHM_PRODUCER ? RINGBUFFER_SHM_CONSUMER : RINGBUFFER_SHM_PRODUCER;
+
+    return process_alive(load_acquire(&rb->hdr->pid[peer]));
+}
+
+uint32_t ringbuffer_shm_data_len(ringbuffer_shm *rb)
+{
+    assert(rb != nullptr);
+
+    uint32_t read_pos = load_acquire(&rb->hdr->read_pos);
+    uint32_t write_pos = load_acquire(&rb->hdr->write_pos);
+
+    return MIN(ringbuffer_pos_distance(rb->hdr->buffer_size, read_pos, write_pos), rb->hdr->buffer_size);
+}
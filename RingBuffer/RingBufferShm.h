@@ -0,0 +1,151 @@
+#ifndef __RINGBUFFER_SHM_H__
+#define __RINGBUFFER_SHM_H__
+
+#include <sys/types.h>
+#include "RingBufferSpsc.h"
+
+#define RINGBUFFER_SHM_MAGIC     0x52425348u    //"RBSH"
+
+#define RINGBUFFER_SHM_PRODUCER  0
+#define RINGBUFFER_SHM_CONSUMER  1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+/*@brief 共享内存中的ringbuffer控制块
+/*
+/* 控制块和数据区在同一块共享内存里，控制块中只保存偏移不保存指针，
+/* 各进程可以把它映射到任意地址。读写位置与 ringbuffer_spsc 相同，取值范围 [0, 2 * buffer_size)，
+/* 等待方在对端位置上做进程间futex等待。
+/* 写位置只在数据拷贝完成后才前移，生产者进程崩溃不会让消费者看到写了一半的数据。
+*/
+typedef struct ringbuffer_shm_hdr_t
+{
+    uint32_t magic;                         //初始化完成后写入 RINGBUFFER_SHM_MAGIC
+    uint32_t buffer_size;                   //数据区大小
+    uint32_t data_offset;                   //数据区相对控制块的偏移
+    int32_t  pid[2];                        //生产者/消费者进程号，0表示未连接
+    uint32_t attached[2];                   //非0表示该角色连接过，pid 为0时说明已断开，等待方不再等待
+
+    uint32_t read_pos __cacheline_aligned;  //读位置，只由消费者修改
+    uint32_t write_pos __cacheline_aligned; //写位置，只由生产者修改
+
+    uint32_t cons_need __cacheline_aligned; //消费者等待的数据长度，0表示没有等待
+    uint32_t prod_need;                     //生产者等待的空闲长度，0表示没有等待
+} ringbuffer_shm_hdr;
+
+/**
+/*@brief 进程内的共享内存ringbuffer句柄
+/*
+*/
+typedef struct ringbuffer_shm_t
+{
+    ringbuffer_shm_hdr *hdr;    //控制块映射地址
+    uint8_t *buffer;            //数据区映射地址
+    size_t map_size;            //映射长度
+    uint32_t peer_pos_cache;    //缓存的对端位置
+    int role;                   //RINGBUFFER_SHM_PRODUCER / RINGBUFFER_SHM_CONSUMER
+} ringbuffer_shm;
+
+/**
+/*@brief 创建共享内存ringbuffer并以 role 身份连接
+/*
+/*@param name 共享内存名称，形如 "/capture"
+/*@param length 数据区大小
+/*@param role 本进程的角色
+/*@return ringbuffer_shm* 失败返回nullptr(errno)，同名共享内存已存在时 errno 为 EEXIST
+*/
+ringbuffer_shm* ringbuffer_shm_create(const char *name, uint32_t length, int role);
+
+/**
+/*@brief 连接已存在的共享内存ringbuffer
+/*
+/* 同一角色已经有存活的进程时失败(errno 为 EBUSY)；原进程已退出或崩溃时由本进程接管，
+/* 读写位置保持不变，消费者可以继续读取崩溃前已提交的数据
+/*
+/*@param name 共享内存名称
+/*@param role 本进程的角色
+/*@return ringbuffer_shm* 失败返回nullptr(errno)
+*/
+ringbuffer_shm* ringbuffer_shm_attach(const char *name, int role);
+
+/**
+/*@brief 断开连接并解除映射，不删除共享内存
+/*
+/*@param rb ringbuffer指针
+ */
+void ringbuffer_shm_detach(ringbuffer_shm *rb);
+
+/**
+/*@brief 删除共享内存，已连接的进程不受影响
+/*
+/*@param name 共享内存名称
+/*@return int 0成功，-1失败(errno)
+ */
+int ringbuffer_shm_unlink(const char *name);
+
+/**
+/*@brief 写入数据，只能由生产者调用
+/*
+/*@param rb ringbuffer指针
+/*@param data 数据指针
+/*@param length 数据长度
+/*@return uint32_t 实际写入长度
+ */
+uint32_t ringbuffer_shm_put(ringbuffer_shm *rb, const uint8_t *data, uint32_t length);
+
+/**
+/*@brief 读取数据，只能由消费者调用
+/*
+/*@param rb ringbuffer指针
+/*@param data 数据指针
+/*@param length 数据长度
+/*@return uint32_t 实际读取长度
+ */
+uint32_t ringbuffer_shm_get(ringbuffer_shm *rb, uint8_t *data, uint32_t length);
+
+/**
+/*@brief 阻塞写入全部数据，只能由生产者调用
+/*
+/*@param rb ringbuffer指针
+/*@param data 数据指针
+/*@param length 数据长度
+/*@param timeout_ms 超时时间(毫秒)，小于0表示一直等待
+/*@return uint32_t 实际写入长度，超时或消费者已断开、已退出时可能小于 length
+ */
+uint32_t ringbuffer_shm_put_wait(ringbuffer_shm *rb, const uint8_t *data, uint32_t length, int timeout_ms);
+
+/**
+/*@brief 阻塞读取数据，只能由消费者调用
+/*
+/*@param rb ringbuffer指针
+/*@param data 数据指针
+/*@param length 最大读取长度
+/*@param timeout_ms 超时时间(毫秒)，小于0表示一直等待
+/*@return uint32_t 实际读取长度，超时或生产者已断开、已退出且没有数据时返回0
+ */
+uint32_t ringbuffer_shm_get_wait(ringbuffer_shm *rb, uint8_t *data, uint32_t length, int timeout_ms);
+
+/**
+/*@brief 对端进程是否存活
+/*
+/*@param rb ringbuffer指针
+/*@return int 1存活，0未连接或已退出
+ */
+int ringbuffer_shm_peer_alive(ringbuffer_shm *rb);
+
+/**
+/*@brief 获取数据长度，结果只是一个快照
+/*
+/*@param rb ringbuffer指针
+/*@return uint32_t 数据长度
+ */
+uint32_t ringbuffer_shm_data_len(ringbuffer_shm *rb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RINGBUFFER_SHM_H__ */
@@ -0,0 +1,396 @@
+#include "RingBufferSpsc.h"
+#include "RingBufferMem.h"
+#include "RingBufferCopy.h"
+#include "RingBufferInternal.h"
+#include <errno.h>
+
+#define RINGBUFFER_SPSC_SPIN_COUNT 256
+
+// 发布写位置，消费者登记了等待且数据量已满足时唤醒它
+// 写位置和等待登记都用 seq_cst，保证双方至少有一方能看到对方的修改
+static inline void spsc_publish_write(ringbuffer_spsc *rb, uint32_t write_pos)
+{
+    __atomic_store_n(&rb->write_pos, write_pos, __ATOMIC_SEQ_CST);
+
+    uint32_t need = __atomic_load_n(&rb->cons_need, __ATOMIC_SEQ_CST);
+
+    if (need != 0 && ringbuffer_pos_distance(rb->buffer_size, load_acquire(&rb->read_pos), write_pos) >= need)
+    {
+        futex_wake(&rb->write_pos, false);
+    }
+}
+
+// 发布读位置，生产者登记了等待且空闲空间已满足时唤醒它
+static inline void spsc_publish_read(ringbuffer_spsc *rb, uint32_t read_pos)
+{
+    __atomic_store_n(&rb->read_pos, read_pos, __ATOMIC_SEQ_CST);
+
+    uint32_t need = __atomic_load_n(&rb->prod_need, __ATOMIC_SEQ_CST);
+
+    if (need != 0 && rb->buffer_size - ringbuffer_pos_distance(rb->buffer_size, read_pos, load_acquire(&rb->write_pos)) >= need)
+    {
+        futex_wake(&rb->read_pos, false);
+    }
+}
+
+// 生产者等待读位置(空闲空间)，消费者等待写位置(数据)
+static inline uint32_t spsc_ready_len(ringbuffer_spsc *rb, bool producer, uint32_t peer_pos)
+{
+    return producer ? rb->buffer_size - ringbuffer_pos_distance(rb->buffer_size, peer_pos, rb->write_pos)
+                    : ringbuffer_pos_distance(rb->buffer_size, rb->read_pos, peer_pos);
+}
+
+/**
+/*@brief 等待空闲空间(生产者)或数据(消费者)达到 need
+/*
+/* 先自旋一小段时间，不满足再登记等待长度并在对端位置上futex休眠
+/*
+/*@param rb ringbuffer指针
+/*@param producer 是否是生产者
+/*@param need 需要的长度
+/*@param deadline 截止时间(CLOCK_MONOTONIC)，nullptr表示一直等待
+/*@return bool false 表示超时
+*/
+static bool spsc_wait(ringbuffer_spsc *rb, bool producer, uint32_t need, const struct timespec *deadline)
+{
+    uint32_t *need_ptr = producer ? &rb->prod_need : &rb->cons_need;
+    uint32_t *peer_pos = producer ? &rb->read_pos : &rb->write_pos;
+    bool ready = false;
+
+    for (int i = 0; i < RINGBUFFER_SPSC_SPIN_COUNT; ++i)
+    {
+        if (spsc_ready_len(rb, producer, load_acquire(peer_pos)) >= need)
+        {
+            return true;
+        }
+        cpu_relax();
+    }
+
+    __atomic_store_n(need_ptr, need, __ATOMIC_SEQ_CST);
+
+    while (true)
+    {
+        uint32_t pos = __atomic_load_n(peer_pos, __ATOMIC_SEQ_CST);
+
+        if (spsc_ready_len(rb, producer, pos) >= need)
+        {
+            ready = true;
+            break;
+        }
+
+        if (deadline == nullptr)
+        {
+            futex_wait(peer_pos, pos, nullptr, false);
+            continue;
+        }
+
+        struct timespec now, timeout;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        timeout.tv_sec = deadline->tv_sec - now.tv_sec;
+        timeout.tv_nsec = deadline->tv_nsec - now.tv_nsec;
+        if (timeout.tv_nsec < 0)
+        {
+            timeout.tv_nsec += 1000000000L;
+            --timeout.tv_sec;
+        }
+        if (timeout.tv_sec < 0)
+        {
+            break;
+        }
+
+        futex_wait(peer_pos, pos, &timeout, false);
+    }
+
+    __atomic_store_n(need_ptr, 0, __ATOMIC_RELAXED);
+
+    return ready;
+}
+
+// 计算超时截止时间，timeout_ms 小于0返回nullptr
+static const struct timespec *spsc_deadline(int timeout_ms, struct timespec *deadline)
+{
+    if (timeout_ms < 0)
+    {
+        return nullptr;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+
+    deadline->tv_sec += timeout_ms / 1000;
+    deadline->tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline->tv_nsec >= 1000000000L)
+    {
+        deadline->tv_nsec -= 1000000000L;
+        ++deadline->tv_sec;
+    }
+    return deadline;
+}
+
+ringbuffer_spsc *ringbuffer_spsc_create(uint32_t length)
+{
+    return ringbuffer_spsc_create_ex(length, RINGBUFFER_FLAG_ALIGN_CACHELINE, -1);
+}
+
+ringbuffer_spsc *ringbuffer_spsc_create_ex(uint32_t length, uint32_t flags, int numa_node)
+{
+    ringbuffer_spsc *rb = nullptr;
+    uint8_t *pool = nullptr;
+
+    assert(length > 0);
+    assert(!(flags & RINGBUFFER_FLAG_MIRRORED));
+
+    if (posix_memalign((void **)&rb, RINGBUFFER_CACHELINE_SIZE, sizeof(ringbuffer_spsc)) != 0)
+    {
+        rb = nullptr;
+        goto exit;
+    }
+
+    pool = ringbuffer_mem_alloc(&length, &flags, numa_node);
+    if (pool == nullptr)
+    {
+        free(rb);
+        rb = nullptr;
+        goto exit;
+    }
+
+    ringbuffer_spsc_init(rb, pool, length);
+    rb->flags = flags;
+
+exit:
+    return rb;
+}
+
+void ringbuffer_spsc_destroy(ringbuffer_spsc *rb)
+{
+    assert(rb != nullptr);
+
+    ringbuffer_mem_free(rb->buffer, rb->buffer_size, rb->flags);
+    free(rb);
+}
+
+void ringbuffer_spsc_init(ringbuffer_spsc *rb, uint8_t *buffer, uint32_t length)
+{
+    assert(rb != nullptr);
+    assert(length > 0 && length <= UINT32_MAX / 2);
+
+    rb->buffer = buffer;
+    rb->buffer_size = ALIGN_DOWN(length, DEFAULT_ALIGN_SIZE);
+    rb->low_watermark = rb->buffer_size - 1;
+    rb->high_watermark = 1;
+    rb->flags = 0;
+
+    ringbuffer_spsc_reset(rb);
+}
+
+void ringbuffer_spsc_reset(ringbuffer_spsc *rb)
+{
+    assert(rb != nullptr);
+
+    rb->read_pos = rb->write_pos_cache = 0;
+    rb->write_pos = rb->read_pos_cache = 0;
+    rb->cons_need = rb->prod_need = 0;
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+uint32_t ringbuffer_spsc_put(ringbuffer_spsc *rb, const uint8_t *data, uint32_t length)
+{
+    assert(rb != nullptr);
+
+    uint32_t write_pos = load_relaxed(&rb->write_pos);
+    uint32_t available_len = rb->buffer_size - ringbuffer_pos_distance(rb->buffer_size, rb->read_pos_cache, write_pos);
+
+    if (available_len < length)
+    {
+        rb->read_pos_cache = load_acquire(&rb->read_pos);
+        available_len = rb->buffer_size - ringbuffer_pos_distance(rb->buffer_size, rb->read_pos_cache, write_pos);
+    }
+
+    if (available_len == 0)
+    {
+        return 0;
+    }
+
+    if (available_len < length)
+    {
+        length = available_len;
+    }
+
+    uint32_t write_index = ringbuffer_pos_index(rb->buffer_size, write_pos);
+
+    if (rb->buffer_size - write_index >= length)
+    {
+        ringbuffer_copy(&rb->buffer[write_index], data, length);
+    }
+    else
+    {
+        ringbuffer_copy(&rb->buffer[write_index], data, rb->buffer_size - write_index);
+        ringbuffer_copy(&rb->buffer[0], &data[rb->buffer_size - write_index], length - (rb->buffer_size - write_index));
+    }
+
+    spsc_publish_write(rb, ringbuffer_pos_advance(rb->buffer_size, write_pos, length));
+
+    return length;
+}
+
+uint32_t ringbuffer_spsc_get(ringbuffer_spsc *rb, uint8_t *data, uint32_t length)
+{
+    assert(rb != nullptr);
+
+    uint32_t read_pos = load_relaxed(&rb->read_pos);
+    uint32_t data_length = ringbuffer_pos_distance(rb->buffer_size, read_pos, rb->write_pos_cache);
+
+    if (data_length < length)
+    {
+        rb->write_pos_cache = load_acquire(&rb->write_pos);
+        data_length = ringbuffer_pos_distance(rb->buffer_size, read_pos, rb->write_pos_cache);
+    }
+
+    if (data_length == 0)
+    {
+        return 0;
+    }
+
+    if (data_length < length)
+    {
+        length = data_length;
+    }
+
+    uint32_t read_index = ringbuffer_pos_index(rb->buffer_size, read_pos);
+
+    if (rb->buffer_size - read_index >= length)
+    {
+        ringbuffer_copy(data, &rb->buffer[read_index], length);
+    }
+    else
+    {
+        ringbuffer_copy(&data[0], &rb->buffer[read_index], rb->buffer_size - read_index);
+        ringbuffer_copy(&data[rb->buffer_size - read_index], &rb->buffer[0], length - (rb->buffer_size - read_index));
+    }
+
+    spsc_publish_read(rb, ringbuffer_pos_advance(rb->buffer_size, read_pos, length));
+
+    return length;
+}
+
+uint32_t ringbuffer_spsc_peek(ringbuffer_spsc *rb, uint8_t **ptr)
+{
+    assert(rb != nullptr);
+
+    *ptr = nullptr;
+
+    uint32_t read_pos = load_relaxed(&rb->read_pos);
+
+    rb->write_pos_cache = load_acquire(&rb->write_pos);
+
+    uint32_t data_length = ringbuffer_pos_distance(rb->buffer_size, read_pos, rb->write_pos_cache);
+
+    if (data_length == 0)
+    {
+        return 0;
+    }
+
+    uint32_t read_index = ringbuffer_pos_index(rb->buffer_size, read_pos);
+
+    *ptr = &rb->buffer[read_index];
+
+    return MIN(data_length, rb->buffer_size - read_index);
+}
+
+uint32_t ringbuffer_spsc_consume(ringbuffer_spsc *rb, uint32_t length)
+{
+    assert(rb != nullptr);
+
+    uint32_t read_pos = load_relaxed(&rb->read_pos);
+    uint32_t data_length = ringbuffer_pos_distance(rb->buffer_size, read_pos, rb->write_pos_cache);
+
+    if (data_length < length)
+    {
+        rb->write_pos_cache = load_acquire(&rb->write_pos);
+        data_length = ringbuffer_pos_distance(rb->buffer_size, read_pos, rb->write_pos_cache);
+    }
+
+    if (data_length < length)
+    {
+        length = data_length;
+    }
+
+    spsc_publish_read(rb, ringbuffer_pos_advance(rb->buffer_size, read_pos, length));
+
+    return length;
+}
+
+void ringbuffer_spsc_set_watermark(ringbuffer_spsc *rb, uint32_t low, uint32_t high)
+{
+    assert(rb != nullptr);
+    assert(low < rb->buffer_size && high > 0);
+
+    rb->low_watermark = low;
+    rb->high_watermark = MIN(high, rb->buffer_size);
+}
+
+uint32_t ringbuffer_spsc_put_wait(ringbuffer_spsc *rb, const uint8_t *data, uint32_t length, int timeout_ms)
+{
+    assert(rb != nullptr);
+
+    struct timespec ts;
+    const struct timespec *deadline = spsc_deadline(timeout_ms, &ts);
+    uint32_t done = 0;
+
+    while (true)
+    {
+        done += ringbuffer_spsc_put(rb, &data[done], length - done);
+        if (done == length)
+        {
+            break;
+        }
+
+        // 数据量降到低水位以下，或者空间足够放下剩余数据时唤醒
+        uint32_t need = MIN(length - done, rb->buffer_size - rb->low_watermark);
+
+        if (!spsc_wait(rb, true, need, deadline))
+        {
+            done += ringbuffer_spsc_put(rb, &data[done], length - done);
+            break;
+        }
+    }
+
+    return done;
+}
+
+uint32_t ringbuffer_spsc_get_wait(ringbuffer_spsc *rb, uint8_t *data, uint32_t length, int timeout_ms)
+{
+    assert(rb != nullptr);
+
+    if (length == 0)
+    {
+        return 0;
+    }
+
+    struct timespec ts;
+    const struct timespec *deadline = spsc_deadline(timeout_ms, &ts);
+    uint32_t need = MIN(length, rb->high_watermark);
+
+    if (ringbuffer_pos_distance(rb->buffer_size, load_relaxed(&rb->read_pos), load_acquire(&rb->write_pos)) < need)
+    {
+        spsc_wait(rb, false, need, deadline);
+    }
+
+    return ringbuffer_spsc_get(rb, data, length);
+}
+
+uint32_t ringbuffer_spsc_data_len(ringbuffer_spsc *rb)
+{
+    assert(rb != nullptr);
+
+    uint32_t read_pos = load_acquire(&rb->read_pos);
+    uint32_t write_pos = load_acquire(&rb->write_pos);
+
+    return MIN(ringbuffer_pos_distance(rb->buffer_size, read_pos, write_pos), rb->buffer_size);
+}
+
+uint32_t ringbuffer_spsc_get_size(ringbuffer_spsc *rb)
+{
+    assert(rb != nullptr);
+    return rb->buffer_size;
+}
@@ -0,0 +1,184 @@
+#ifndef __RINGBUFFER_SPSC_H__
+#define __RINGBUFFER_SPSC_H__
+
+#include "RingBuffer.h"
+
+#define __cacheline_aligned __attribute__((aligned(RINGBUFFER_CACHELINE_SIZE)))
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+/*@brief 单生产者单消费者无锁ringbuffer
+/*
+/* 读写位置取值范围为 [0, 2 * buffer_size)，高半区相当于 ringbuffer 的 mirror 位。
+/* 读位置只由消费者修改，写位置只由生产者修改，分别放在独立的cache line上，
+/* 通过 acquire/release 同步；双方各自缓存对端位置，只有缓存不够用时才重新读取。
+/* 阻塞接口在读写位置上做futex等待，等待方把需要的长度登记在 cons_need/prod_need，
+/* 对端只有在登记了等待者且条件满足时才调用 futex_wake。
+*/
+typedef struct ringbuffer_spsc_t
+{
+    /* 消费者独占 */
+    uint32_t read_pos __cacheline_aligned;  //读位置
+    uint32_t write_pos_cache;               //消费者缓存的写位置
+
+    /* 生产者独占 */
+    uint32_t write_pos __cacheline_aligned; //写位置
+    uint32_t read_pos_cache;                //生产者缓存的读位置
+
+    /* 等待登记，只在阻塞时写入 */
+    uint32_t cons_need __cacheline_aligned; //消费者等待的数据长度，0表示没有等待
+    uint32_t prod_need;                     //生产者等待的空闲长度，0表示没有等待
+
+    /* 只读 */
+    uint32_t buffer_size __cacheline_aligned;
+    uint32_t low_watermark;                 //生产者阻塞后，数据量降到该值以下才唤醒
+    uint32_t high_watermark;                //消费者阻塞后，数据量达到该值才唤醒
+    uint32_t flags;                         //缓存区创建标志 RINGBUFFER_FLAG_*
+    uint8_t *buffer;
+} ringbuffer_spsc;
+
+/**
+/*@brief 创建SPSC ringbuffer
+/*
+/*@param length 缓存区大小
+/*@return ringbuffer_spsc*
+*/
+ringbuffer_spsc* ringbuffer_spsc_create(uint32_t length);
+
+/**
+/*@brief 按创建标志创建SPSC ringbuffer
+/*
+/*@param length 缓存区大小
+/*@param flags RINGBUFFER_FLAG_* 组合，不支持 RINGBUFFER_FLAG_MIRRORED
+/*@param numa_node 缓存区绑定的NUMA节点，小于0表示不绑定
+/*@return ringbuffer_spsc* 失败返回nullptr
+*/
+ringbuffer_spsc* ringbuffer_spsc_create_ex(uint32_t length, uint32_t flags, int numa_node);
+
+/**
+/*@brief 销毁SPSC ringbuffer
+/*
+/*@param rb ringbuffer指针
+ */
+void ringbuffer_spsc_destroy(ringbuffer_spsc *rb);
+
+/**
+/*@brief 初始化SPSC ringbuffer
+/*
+/*@param rb ringbuffer指针
+/*@param buffer 缓存区指针
+/*@param length 缓存区大小
+ */
+void ringbuffer_spsc_init(ringbuffer_spsc *rb, uint8_t *buffer, uint32_t length);
+
+/**
+/*@brief 重置SPSC ringbuffer，调用时不能有生产者和消费者在使用
+/*
+/*@param rb ringbuffer指针
+ */
+void ringbuffer_spsc_reset(ringbuffer_spsc *rb);
+
+/**
+/*@brief 向ringbuffer写入数据，只能由生产者线程调用
+/*
+/*@param rb ringbuffer指针
+/*@param data 数据指针
+/*@param length 数据长度
+/*@return uint32_t 实际写入长度
+ */
+uint32_t ringbuffer_spsc_put(ringbuffer_spsc *rb, const uint8_t *data, uint32_t length);
+
+/**
+/*@brief 从ringbuffer读取数据，只能由消费者线程调用
+/*
+/*@param rb ringbuffer指针
+/*@param data 数据指针
+/*@param length 数据长度
+/*@return uint32_t 实际读取长度
+ */
+uint32_t ringbuffer_spsc_get(ringbuffer_spsc *rb, uint8_t *data, uint32_t length);
+
+/**
+/*@brief 获取 ringbuffer 第一段连续可读数据，不移动读位置，只能由消费者线程调用
+/*
+/* 与 ringbuffer_peek 不同，返回的数据在 ringbuffer_spsc_consume 之前不会被生产者覆盖
+/*
+/*@param rb ringbuffer指针
+/*@param ptr 第一个可读数据指针
+/*@return uint32_t 连续可读数据长度
+ */
+uint32_t ringbuffer_spsc_peek(ringbuffer_spsc *rb, uint8_t **ptr);
+
+/**
+/*@brief 丢弃已读取的数据，释放空间给生产者，只能由消费者线程调用
+/*
+/*@param rb ringbuffer指针
+/*@param length 丢弃长度
+/*@return uint32_t 实际丢弃长度
+ */
+uint32_t ringbuffer_spsc_consume(ringbuffer_spsc *rb, uint32_t length);
+
+/**
+/*@brief 设置阻塞接口的水位线，调用时不能有线程阻塞在该ringbuffer上
+/*
+/* 默认 low = buffer_size - 1、high = 1，即有1字节空间/数据就唤醒对端。
+/* 调低 low、调高 high 可以让对端攒够一批再被唤醒，减少唤醒次数。
+/*
+/*@param rb ringbuffer指针
+/*@param low 低水位
+/*@param high 高水位
+ */
+void ringbuffer_spsc_set_watermark(ringbuffer_spsc *rb, uint32_t low, uint32_t high);
+
+/**
+/*@brief 阻塞写入全部数据，只能由生产者线程调用
+/*
+/* 空间不足时先短暂自旋，再在futex上休眠，直到消费者腾出空间或超时
+/*
+/*@param rb ringbuffer指针
+/*@param data 数据指针
+/*@param length 数据长度
+/*@param timeout_ms 超时时间(毫秒)，小于0表示一直等待
+/*@return uint32_t 实际写入长度，超时时可能小于 length
+ */
+uint32_t ringbuffer_spsc_put_wait(ringbuffer_spsc *rb, const uint8_t *data, uint32_t length, int timeout_ms);
+
+/**
+/*@brief 阻塞读取数据，只能由消费者线程调用
+/*
+/* 可读数据达到 MIN(length, high_watermark) 时读取并返回，否则先短暂自旋，再在futex上休眠
+/*
+/*@param rb ringbuffer指针
+/*@param data 数据指针
+/*@param length 最大读取长度
+/*@param timeout_ms 超时时间(毫秒)，小于0表示一直等待
+/*@return uint32_t 实际读取长度，超时返回已有的数据，可能为0
+ */
+uint32_t ringbuffer_spsc_get_wait(ringbuffer_spsc *rb, uint8_t *data, uint32_t length, int timeout_ms);
+
+/**
+/*@brief 获取ringbuffer数据长度，可在任意线程调用，结果只是一个快照
+/*
+/*@param rb ringbuffer指针
+/*@return uint32_t 数据长度
+ */
+uint32_t ringbuffer_spsc_data_len(ringbuffer_spsc *rb);
+
+/**
+/*@brief 获取ringbuffer大小
+/*
+/*@param rb ringbuffer指针
+/*@return uint32_t buffer长度
+ */
+uint32_t ringbuffer_spsc_get_size(ringbuffer_spsc *rb);
+
+#define ringbuffer_spsc_available_len(rb) ((rb)->buffer_size - ringbuffer_spsc_data_len(rb))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RINGBUFFER_SPSC_H__ */
@@ -1,5 +1,5 @@
 #include <stdio.h>
-#include "RingBuffer.h"
+#include "RingBufferSpsc.h"
 #include <pthread.h>
 #include <time.h>
 #include <sys/time.h>
@@ -24,7 +24,7 @@ void* write_data_task(void* args)               //线程1 往循环buffer中写
         return NULL;
     }
     uint8_t buf[1024]={0};
-    ringbuffer *rb = (ringbuffer*)args;     //获取传入进来的循环buffer参数
+    ringbuffer_spsc *rb = (ringbuffer_spsc*)args;     //获取传入进来的循环buffer参数
     int ret = -1;
     int data_len = 0;
 
@@ -32,10 +32,11 @@ void* write_data_task(void* args)               //线程1 往循环buffer中写
     {
 
         data_len = 512+rand()%512;              //获取随机长度写入循环buffer
-        fread(buf, data_len, 1, fp);            //根据长度从文件中读出原始数据写入循环buffer
-        do{
-            ret = ringbuffer_put(rb, buf, data_len); //往循环buffer中写数据
-        }while(ret == -1);                      //阻塞等待写入成功
+        data_len = fread(buf, 1, data_len, fp); //根据长度从文件中读出原始数据写入循环buffer，文件末尾可能不足
+        ret = ringbuffer_spsc_put_wait(rb, buf, data_len, -1); //往循环buffer中写数据，空间不足时阻塞等待
+        if(ret != data_len){
+            printf("short write %d/%d\n", ret, data_len);
+        }
     }
     is_runing=0;
 
@@ -55,26 +56,26 @@ void* read_data_task(void* args)
     }
     #endif
     int ret = -1;
-    ringbuffer_t *rb = (ringbuffer_t*)args;     //获取传入进来的循环buffer参数
+    ringbuffer_spsc *rb = (ringbuffer_spsc*)args;     //获取传入进来的循环buffer参数
     uint8_t buf[1024]={0};
     
     long start_time = get_sys_time();           //获取系统时间
     int data_len=0;
-    while (is_runing)
+    long long total_len = 0;
+    while (is_runing || ringbuffer_spsc_data_len(rb) > 0)  //写线程结束后继续读完剩余数据
     {
         data_len = 512+rand()%512;              //获取随机长度从循环buffer中读取数据
-        do{
-            ret = ringbuffer_get(rb, buf, data_len);  //从循环buffer中读数据
-        }while(ret==-1);                        //阻塞等待读取数据成功
+        ret = ringbuffer_spsc_get_wait(rb, buf, data_len, 100);  //从循环buffer中读数据，没有数据时最多阻塞100ms
+        total_len += ret;
         #if ENABLE_WRITE_OUT_FILE
-        fwrite(buf, data_len, 1, fp);           //将从循环buffer中读取的数据写入文件
+        fwrite(buf, ret, 1, fp);                 //将从循环buffer中读取的数据写入文件
         #endif
     }
     long end_time = get_sys_time();             //获取系统时间
     int use_time = end_time-start_time;
     double use_s = ((double)use_time/1000000.0);
-    double rate = ((500*1024*1024*8.0)/use_s)/(1024*1024*1024.0);
-    printf("500M Data Use time=%dus(%.2lfS) rate=%.2lfGbps\n", use_time, use_s, rate);
+    double rate = ((total_len*8.0)/use_s)/(1024*1024*1024.0);
+    printf("%.2lfM Data Use time=%dus(%.2lfS) rate=%.2lfGbps\n", total_len/(1024*1024.0), use_time, use_s, rate);
 
     #if ENABLE_WRITE_OUT_FILE
     fclose(fp);
@@ -85,7 +86,7 @@ void* read_data_task(void* args)
 int main(int argc, char** argv)
 {
     pthread_t th[2]={0};
-    ringbuffer_t* rb = ringbuffer_create(32*1024);       //创建循环buffer
+    ringbuffer_spsc* rb = ringbuffer_spsc_create(32*1024); //创建单生产者单消费者循环buffer
 
     srand(time(NULL));                                  //初始化随机数
     is_runing = 1;
@@ -98,7 +99,7 @@ int main(int argc, char** argv)
 
     printf("Finish Test Ringbuffer...\n");
 
-    ringbuffer_destroy(rb);                             //销毁循环buffer
+    ringbuffer_spsc_destroy(rb);                        //销毁循环buffer
 
     return 0;
 }
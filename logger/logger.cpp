@@ -0,0 +1,958 @@
+#include "logger.h"
+#include "RingBufferSpsc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#define LOGGER_MAX_ARGS     16
+#define LOGGER_LINE_MAX     4096            //单行格式化结果最大长度
+#define LOGGER_OUT_SIZE     (64 * 1024)     //后台线程输出缓存大小
+#define LOGGER_IOV_MAX      64              //一次 writev 最多的记录数
+#define LOGGER_IDLE_NS      1000000         //没有日志时后台线程的休眠时间
+#define LOGGER_BLOCK_WAIT_MS 10             //BLOCK 策略每次等待空间的时长，超时后检查日志是否已关闭
+#define LOGGER_CALIBRATE_NS 1000000000ull   //后台线程重新校准时间戳换算的间隔
+
+static_assert(sizeof(size_t) == sizeof(long), "size_t is formatted as long");
+
+enum log_arg_type
+{
+    ARG_NONE,
+    ARG_INT,
+    ARG_LONG,
+    ARG_LLONG,
+    ARG_DOUBLE,
+    ARG_LDOUBLE,
+    ARG_PTR,
+    ARG_STR,
+};
+
+/**
+/*@brief 注册后的格式串
+/*
+/* 格式串按转换说明拆成若干段，每段是一段普通文本加至多一个转换说明，
+/* 后台线程对每段单独调用 snprintf，段内只有一个参数
+*/
+typedef struct log_format_t
+{
+    log_level_t     level;
+    const char      *file;
+    int             line;
+    uint32_t        nseg;
+    uint8_t         types[LOGGER_MAX_ARGS + 1];
+    char            *segments[LOGGER_MAX_ARGS + 1];
+} log_format_t;
+
+/**
+/*@brief 日志记录头，后面紧跟按格式串顺序存放的原始参数
+/*
+*/
+typedef struct log_record_t
+{
+    uint32_t        fmt_id;
+    uint32_t        size;       //记录总长度，包括记录头
+    uint64_t        timestamp;  //logger_clock() 时间戳，后台线程换算成墙上时间
+} log_record_t;
+
+enum log_thread_state
+{
+    LOG_THREAD_ACTIVE,      //所属线程在使用
+    LOG_THREAD_CLOSED,      //所属线程已退出，后台线程写完后释放
+    LOG_THREAD_ORPHANED,    //日志已关闭，所属线程退出或下次写日志时释放缓存区
+};
+
+/**
+/*@brief 线程日志缓存
+/*
+*/
+typedef struct log_thread_t
+{
+    ringbuffer_spsc *rb;
+    pid_t           tid;
+    int             state;
+    uint32_t        carry_len;                  //上一次读取剩下的不完整记录长度，只由读取方访问
+    uint8_t         carry[LOGGER_MAX_RECORD];
+} log_thread_t;
+
+volatile int logger_level = LOG_LEVEL_INFO;
+
+static log_format_t     g_formats[LOGGER_MAX_FORMATS];
+static uint32_t         g_format_count = 0;
+static log_thread_t     *g_threads[LOGGER_MAX_THREADS];
+static pthread_mutex_t  g_mutex = PTHREAD_MUTEX_INITIALIZER;   //保护格式串和线程缓存的注册
+
+static int              g_fd = -1;
+static int              g_running = 0;
+static uint32_t         g_buffer_size = LOGGER_DEFAULT_BUFFER;
+static logger_policy_t  g_policy = LOGGER_POLICY_DROP;
+static uint64_t         g_dropped = 0;
+static pthread_t        g_thread;
+
+static pthread_mutex_t  g_drain_mutex = PTHREAD_MUTEX_INITIALIZER; //同一时刻只有一个线程在读取缓存
+static pthread_mutex_t  g_flush_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t   g_flush_cond = PTHREAD_COND_INITIALIZER;
+static uint64_t         g_flush_req = 0;
+static uint64_t         g_flush_done = 0;
+
+static const char *g_level_names[] = {"DEBUG", "INFO ", "WARN ", "ERROR"};
+
+static uint64_t         g_clock_base = 0;       //校准时的 logger_clock()
+static uint64_t         g_realtime_base = 0;    //校准时的 CLOCK_REALTIME 纳秒
+static double           g_ns_per_tick = 1.0;
+static uint64_t         g_calib_clock = 0;      //初次校准开始时的 logger_clock()，用整个运行时长计算频率
+static uint64_t         g_calib_mono = 0;       //初次校准开始时的 CLOCK_MONOTONIC 纳秒
+static uint64_t         g_calib_last = 0;       //上次校准的 CLOCK_MONOTONIC 纳秒
+
+static inline uint64_t realtime_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static inline uint64_t monotonic_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/**
+/*@brief 写日志用的时间戳
+/*
+/* x86 上直接读 TSC，比 clock_gettime 便宜得多，换算放到后台线程
+*/
+static inline uint64_t logger_clock(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return realtime_ns();
+#endif
+}
+
+/**
+/*@brief 校准 logger_clock 与墙上时间的换算关系
+/*
+*/
+static void logger_calibrate(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    struct timespec ts = {0, 10000000};
+    g_calib_clock = logger_clock();
+    g_calib_mono = monotonic_ns();
+
+    nanosleep(&ts, NULL);
+
+    g_clock_base = logger_clock();
+    g_realtime_base = realtime_ns();
+    g_calib_last = monotonic_ns();
+    g_ns_per_tick = (double)(g_calib_last - g_calib_mono) / (double)(g_clock_base - g_calib_clock);
+#endif
+}
+
+/**
+/*@brief 重新校准，由后台线程每轮读取后调用，调用时持有 g_drain_mutex
+/*
+/* 10ms 的初次采样误差会随时间累积，每隔 LOGGER_CALIBRATE_NS 用从初次校准到现在的时长重新计算频率，
+/* 并把换算基准移到当前时刻，同时跟上 CLOCK_REALTIME 的调整
+*/
+static void logger_recalibrate(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    uint64_t mono = monotonic_ns();
+    if (mono - g_calib_last < LOGGER_CALIBRATE_NS)
+    {
+        return;
+    }
+
+    uint64_t clock = logger_clock();
+    g_ns_per_tick = (double)(mono - g_calib_mono) / (double)(clock - g_calib_clock);
+    g_clock_base = clock;
+    g_realtime_base = realtime_ns();
+    g_calib_last = mono;
+#endif
+}
+
+// 时间戳换算成 CLOCK_REALTIME 纳秒
+static inline uint64_t logger_clock_to_ns(uint64_t clock)
+{
+    return g_realtime_base + (int64_t)((double)(int64_t)(clock - g_clock_base) * g_ns_per_tick);
+}
+
+/**
+/*@brief 线程退出时交还日志缓存
+/*
+*/
+struct log_thread_handle
+{
+    log_thread_t *thread = nullptr;
+
+    ~log_thread_handle()
+    {
+        if (thread && __atomic_exchange_n(&thread->state, LOG_THREAD_CLOSED, __ATOMIC_ACQ_REL) == LOG_THREAD_ORPHANED)
+        {
+            ringbuffer_spsc_destroy(thread->rb);
+            free(thread);
+        }
+    }
+};
+
+static thread_local log_thread_handle t_handle;
+static thread_local bool t_drain_thread = false;   //当前线程是否是后台写线程
+
+/**
+/*@brief 解析一个转换说明，返回参数类型
+/*
+/*@param p 指向 '%' 之后的字符，返回时指向转换字符之后
+/*@return int 参数类型，不支持的转换返回 -1
+*/
+static int parse_spec(const char **p)
+{
+    const char *s = *p;
+    int longs = 0;
+    bool ldouble = false;
+
+    while (*s && strchr("-+ #0'", *s)) ++s;
+    while (*s >= '0' && *s <= '9') ++s;
+    if (*s == '.')
+    {
+        ++s;
+        while (*s >= '0' && *s <= '9') ++s;
+    }
+
+    while (*s && strchr("hlLqjzt", *s))
+    {
+        if (*s == 'l') ++longs;
+        if (*s == 'q') longs = 2;
+        if (*s == 'L') ldouble = true;
+        if (*s == 'j' || *s == 'z' || *s == 't') longs = (longs > 1 ? longs : 1);
+        ++s;
+    }
+
+    char conv = *s;
+    if (conv == '\0')
+    {
+        return -1;
+    }
+    *p = s + 1;
+
+    switch (conv)
+    {
+    case 'd': case 'i': case 'u': case 'o': case 'x': case 'X': case 'c':
+        return longs == 0 ? ARG_INT : (longs == 1 ? ARG_LONG : ARG_LLONG);
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+        return ldouble ? ARG_LDOUBLE : ARG_DOUBLE;
+    case 's':
+        return longs == 0 ? ARG_STR : -1;
+    case 'p':
+        return ARG_PTR;
+    default:
+        return -1;
+    }
+}
+
+uint32_t logger_register_format(log_level_t level, const char *file, int line, const char *fmt)
+{
+    log_format_t format;
+    const char *start = fmt;
+    const char *p = fmt;
+    uint32_t id = 0;
+
+    memset(&format, 0, sizeof(format));
+    format.level = level;
+    format.file = file;
+    format.line = line;
+
+    while (*p)
+    {
+        if (*p != '%')
+        {
+            ++p;
+            continue;
+        }
+        if (p[1] == '%')
+        {
+            p += 2;
+            continue;
+        }
+
+        ++p;
+        int type = parse_spec(&p);
+        if (type < 0 || format.nseg >= LOGGER_MAX_ARGS)
+        {
+            goto fail;
+        }
+        format.types[format.nseg] = (uint8_t)type;
+        format.segments[format.nseg] = strndup(start, p - start);
+        ++format.nseg;
+        start = p;
+    }
+
+    if (*start)
+    {
+        format.types[format.nseg] = ARG_NONE;
+        format.segments[format.nseg] = strdup(start);
+        ++format.nseg;
+    }
+
+    pthread_mutex_lock(&g_mutex);
+    if (g_format_count >= LOGGER_MAX_FORMATS)
+    {
+        pthread_mutex_unlock(&g_mutex);
+        goto fail;
+    }
+    g_formats[g_format_count] = format;
+    id = ++g_format_count;
+    pthread_mutex_unlock(&g_mutex);
+
+    return id;
+
+fail:
+    for (uint32_t i = 0; i < format.nseg; ++i)
+    {
+        free(format.segments[i]);
+    }
+    return 0;
+}
+
+/**
+/*@brief 获取当前线程的日志缓存，第一次调用时创建
+/*
+*/
+static log_thread_t *logger_thread(void)
+{
+    log_thread_t *thread = t_handle.thread;
+
+    if (thread && __atomic_load_n(&thread->state, __ATOMIC_ACQUIRE) == LOG_THREAD_ACTIVE)
+    {
+        return thread;
+    }
+
+    // 上一次 logger_init 留下的缓存已经被关闭，没有其他线程再访问
+    if (thread)
+    {
+        ringbuffer_spsc_destroy(thread->rb);
+        free(thread);
+        t_handle.thread = nullptr;
+    }
+
+    thread = (log_thread_t *)calloc(1, sizeof(log_thread_t));
+    if (!thread)
+    {
+        return nullptr;
+    }
+    thread->rb = ringbuffer_spsc_create(g_buffer_size);
+    if (!thread->rb)
+    {
+        free(thread);
+        return nullptr;
+    }
+    thread->tid = (pid_t)syscall(SYS_gettid);
+    thread->state = LOG_THREAD_ACTIVE;
+
+    pthread_mutex_lock(&g_mutex);
+    for (int i = 0; i < LOGGER_MAX_THREADS; ++i)
+    {
+        if (!g_threads[i])
+        {
+            __atomic_store_n(&g_threads[i], thread, __ATOMIC_RELEASE);
+            t_handle.thread = thread;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&g_mutex);
+
+    if (!t_handle.thread)
+    {
+        ringbuffer_spsc_destroy(thread->rb);
+        free(thread);
+        return nullptr;
+    }
+
+    return thread;
+}
+
+void logger_write(uint32_t fmt_id, ...)
+{
+    if (!__atomic_load_n(&g_running, __ATOMIC_ACQUIRE))
+    {
+        return;
+    }
+
+    log_thread_t *thread = logger_thread();
+    if (!thread)
+    {
+        __atomic_add_fetch(&g_dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    const log_format_t *format = &g_formats[fmt_id - 1];
+    uint8_t record[LOGGER_MAX_RECORD];
+    log_record_t *hdr = (log_record_t *)record;
+    uint32_t size = sizeof(log_record_t);
+    va_list ap;
+
+    hdr->fmt_id = fmt_id;
+    hdr->timestamp = logger_clock();
+
+    va_start(ap, fmt_id);
+    for (uint32_t i = 0; i < format->nseg; ++i)
+    {
+        switch (format->types[i])
+        {
+        case ARG_INT:
+        {
+            long long v = va_arg(ap, int);
+            memcpy(&record[size], &v, sizeof(v));
+            size += sizeof(v);
+            break;
+        }
+        case ARG_LONG:
+        {
+            long long v = va_arg(ap, long);
+            memcpy(&record[size], &v, sizeof(v));
+            size += sizeof(v);
+            break;
+        }
+        case ARG_LLONG:
+        {
+            long long v = va_arg(ap, long long);
+            memcpy(&record[size], &v, sizeof(v));
+            size += sizeof(v);
+            break;
+        }
+        case ARG_DOUBLE:
+        {
+            double v = va_arg(ap, double);
+            memcpy(&record[size], &v, sizeof(v));
+            size += sizeof(v);
+            break;
+        }
+        case ARG_LDOUBLE:
+        {
+            long double v = va_arg(ap, long double);
+            memcpy(&record[size], &v, sizeof(v));
+            size += sizeof(v);
+            break;
+        }
+        case ARG_PTR:
+        {
+            void *v = va_arg(ap, void *);
+            memcpy(&record[size], &v, sizeof(v));
+            size += sizeof(v);
+            break;
+        }
+        case ARG_STR:
+        {
+            const char *s = va_arg(ap, const char *);
+            // 给后面的参数留出空间，超出的部分截断
+            int room = (int)(LOGGER_MAX_RECORD - size - sizeof(uint32_t))
+                       - (int)((format->nseg - i - 1) * sizeof(long double));
+            uint32_t len = (s && room > 0) ? (uint32_t)strnlen(s, room) : 0;
+
+            memcpy(&record[size], &len, sizeof(len));
+            memcpy(&record[size + sizeof(len)], s, len);
+            size += sizeof(len) + len;
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    va_end(ap);
+
+    hdr->size = size;
+
+    if (g_policy == LOGGER_POLICY_BLOCK)
+    {
+        // 分段等待，logger_shutdown 后后台线程不再读取，放弃剩余部分
+        uint32_t done = 0;
+        while (done < size && __atomic_load_n(&g_running, __ATOMIC_ACQUIRE))
+        {
+            done += ringbuffer_spsc_put_wait(thread->rb, record + done, size - done, LOGGER_BLOCK_WAIT_MS);
+        }
+        if (done < size)
+        {
+            __atomic_add_fetch(&g_dropped, 1, __ATOMIC_RELAXED);
+        }
+    }
+    else if (ringbuffer_spsc_available_len(thread->rb) < size ||
+             ringbuffer_spsc_put(thread->rb, record, size) != size)
+    {
+        __atomic_add_fetch(&g_dropped, 1, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+/*@brief 把一条记录格式化成一行文本
+/*
+/*@return int 文本长度
+*/
+static int format_record(const log_record_t *hdr, const log_thread_t *thread, char *out, int room)
+{
+    static __thread time_t cached_sec = -1;
+    static __thread char cached_time[32];
+
+    const log_format_t *format = &g_formats[hdr->fmt_id - 1];
+    const uint8_t *arg = (const uint8_t *)(hdr + 1);
+    uint64_t ns = logger_clock_to_ns(hdr->timestamp);
+    time_t sec = (time_t)(ns / 1000000000ull);
+    int len = 0;
+
+    if (sec != cached_sec)
+    {
+        struct tm tm;
+        localtime_r(&sec, &tm);
+        strftime(cached_time, sizeof(cached_time), "%Y-%m-%d %H:%M:%S", &tm);
+        cached_sec = sec;
+    }
+
+    len = snprintf(out, room, "%s.%06u %s %d %s:%d ", cached_time,
+                   (unsigned)(ns % 1000000000ull / 1000),
+                   g_level_names[format->level], thread->tid, format->file, format->line);
+
+    for (uint32_t i = 0; i < format->nseg && len < room - 1; ++i)
+    {
+        const char *seg = format->segments[i];
+        char *dst = out + len;
+        int left = room - 1 - len;
+        int n = 0;
+
+        switch (format->types[i])
+        {
+        case ARG_NONE:
+            n = snprintf(dst, left, seg, 0);
+            break;
+        case ARG_INT:
+        {
+            long long v;
+            memcpy(&v, arg, sizeof(v));
+            arg += sizeof(v);
+            n = snprintf(dst, left, seg, (int)v);
+            break;
+        }
+        case ARG_LONG:
+        {
+            long long v;
+            memcpy(&v, arg, sizeof(v));
+            arg += sizeof(v);
+            n = snprintf(dst, left, seg, (long)v);
+            break;
+        }
+        case ARG_LLONG:
+        {
+            long long v;
+            memcpy(&v, arg, sizeof(v));
+            arg += sizeof(v);
+            n = snprintf(dst, left, seg, v);
+            break;
+        }
+        case ARG_DOUBLE:
+        {
+            double v;
+            memcpy(&v, arg, sizeof(v));
+            arg += sizeof(v);
+            n = snprintf(dst, left, seg, v);
+            break;
+        }
+        case ARG_LDOUBLE:
+        {
+            long double v;
+            memcpy(&v, arg, sizeof(v));
+            arg += sizeof(v);
+            n = snprintf(dst, left, seg, v);
+            break;
+        }
+        case ARG_PTR:
+        {
+            void *v;
+            memcpy(&v, arg, sizeof(v));
+            arg += sizeof(v);
+            n = snprintf(dst, left, seg, v);
+            break;
+        }
+        case ARG_STR:
+        {
+            // 字符串在记录里没有结尾的 '\0'，用 %.*s 的方式无法套用原有的宽度，复制到临时缓存
+            char str[LOGGER_MAX_RECORD];
+            uint32_t slen;
+            memcpy(&slen, arg, sizeof(slen));
+            memcpy(str, arg + sizeof(slen), slen);
+            str[slen] = '\0';
+            arg += sizeof(slen) + slen;
+            n = snprintf(dst, left, seg, str);
+            break;
+        }
+        }
+
+        if (n > 0)
+        {
+            len += n < left ? n : left - 1;
+        }
+    }
+
+    if (len > room - 1)
+    {
+        len = room - 1;
+    }
+    out[len++] = '\n';
+
+    return len;
+}
+
+/**
+/*@brief 写出全部 iovec，处理部分写入
+/*
+*/
+static void write_iov(struct iovec *iov, int count)
+{
+    while (count > 0)
+    {
+        ssize_t n = writev(g_fd, iov, count);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return;
+        }
+
+        while (count > 0 && (size_t)n >= iov->iov_len)
+        {
+            n -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0)
+        {
+            iov->iov_base = (char *)iov->iov_base + n;
+            iov->iov_len -= n;
+        }
+    }
+}
+
+/**
+/*@brief 读取所有线程缓存中的日志，格式化后批量 writev，调用时持有 g_drain_mutex
+/*
+/*@return size_t 处理的记录数
+*/
+static size_t drain_all(void)
+{
+    static uint8_t stage[LOGGER_OUT_SIZE + LOGGER_MAX_RECORD];
+    static char out[LOGGER_OUT_SIZE];
+    struct iovec iov[LOGGER_IOV_MAX];
+    int iov_count = 0;
+    size_t out_len = 0;
+    size_t records = 0;
+
+    for (int i = 0; i < LOGGER_MAX_THREADS; ++i)
+    {
+        log_thread_t *thread = __atomic_load_n(&g_threads[i], __ATOMIC_ACQUIRE);
+        if (!thread || !thread->rb)
+        {
+            continue;
+        }
+
+        // 先读状态再读数据，看到 CLOSED 时所属线程写入的数据都已可见
+        int state = __atomic_load_n(&thread->state, __ATOMIC_ACQUIRE);
+        // 只读本轮开始时已有的数据，写线程持续写入时本轮也能结束
+        uint32_t pending = ringbuffer_spsc_data_len(thread->rb);
+
+        while (pending > 0)
+        {
+            memcpy(stage, thread->carry, thread->carry_len);
+            uint32_t got = ringbuffer_spsc_get(thread->rb, stage + thread->carry_len, MIN(pending, LOGGER_OUT_SIZE));
+            uint32_t len = thread->carry_len + got;
+            uint32_t pos = 0;
+
+            if (got == 0)
+            {
+                break;
+            }
+            pending -= got;
+
+            while (len - pos >= sizeof(log_record_t))
+            {
+                log_record_t *hdr = (log_record_t *)&stage[pos];
+                if (len - pos < hdr->size)
+                {
+                    break;
+                }
+
+                if (iov_count == LOGGER_IOV_MAX || LOGGER_OUT_SIZE - out_len < LOGGER_LINE_MAX)
+                {
+                    write_iov(iov, iov_count);
+                    iov_count = 0;
+                    out_len = 0;
+                }
+
+                // 记录头不一定对齐，复制出来再用
+                log_record_t aligned[LOGGER_MAX_RECORD / sizeof(log_record_t)];
+                memcpy(aligned, hdr, hdr->size);
+
+                int n = format_record(aligned, thread, out + out_len, LOGGER_LINE_MAX);
+                iov[iov_count].iov_base = out + out_len;
+                iov[iov_count].iov_len = n;
+                ++iov_count;
+                out_len += n;
+                pos += hdr->size;
+                ++records;
+            }
+
+            thread->carry_len = len - pos;
+            memmove(thread->carry, stage + pos, thread->carry_len);
+        }
+
+        if (state == LOG_THREAD_CLOSED)
+        {
+            pthread_mutex_lock(&g_mutex);
+            g_threads[i] = nullptr;
+            pthread_mutex_unlock(&g_mutex);
+            ringbuffer_spsc_destroy(thread->rb);
+            free(thread);
+        }
+    }
+
+    write_iov(iov, iov_count);
+
+    return records;
+}
+
+/**
+/*@brief 后台写线程
+/*
+*/
+static void *logger_thread_main(void *args)
+{
+    (void)args;
+
+    t_drain_thread = true;
+
+    while (true)
+    {
+        pthread_mutex_lock(&g_flush_mutex);
+        uint64_t req = g_flush_req;
+        bool running = __atomic_load_n(&g_running, __ATOMIC_ACQUIRE);
+        pthread_mutex_unlock(&g_flush_mutex);
+
+        pthread_mutex_lock(&g_drain_mutex);
+        size_t records = drain_all();
+        logger_recalibrate();
+        pthread_mutex_unlock(&g_drain_mutex);
+
+        // req 之前写入的日志已在这一轮读出，持续有日志时 logger_flush 也不用等到缓存读空
+        pthread_mutex_lock(&g_flush_mutex);
+        g_flush_done = req;
+        pthread_cond_broadcast(&g_flush_cond);
+
+        if (records == 0)
+        {
+            if (!running)
+            {
+                pthread_mutex_unlock(&g_flush_mutex);
+                break;
+            }
+
+            if (g_flush_req == req)
+            {
+                struct timespec ts;
+                clock_gettime(CLOCK_REALTIME, &ts);
+                ts.tv_nsec += LOGGER_IDLE_NS;
+                if (ts.tv_nsec >= 1000000000)
+                {
+                    ts.tv_sec += 1;
+                    ts.tv_nsec -= 1000000000;
+                }
+                pthread_cond_timedwait(&g_flush_cond, &g_flush_mutex, &ts);
+            }
+        }
+        pthread_mutex_unlock(&g_flush_mutex);
+    }
+
+    return nullptr;
+}
+
+int logger_init(const char *path, uint32_t buffer_size, logger_policy_t policy)
+{
+    if (g_running)
+    {
+        return -1;
+    }
+
+    if (path)
+    {
+        g_fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (g_fd < 0)
+        {
+            return -1;
+        }
+    }
+    else
+    {
+        g_fd = STDERR_FILENO;
+    }
+
+    logger_calibrate();
+
+    g_buffer_size = buffer_size ? buffer_size : LOGGER_DEFAULT_BUFFER;
+    if (g_buffer_size < 4 * LOGGER_MAX_RECORD)
+    {
+        g_buffer_size = 4 * LOGGER_MAX_RECORD;
+    }
+    g_policy = policy;
+    g_dropped = 0;
+    g_flush_req = g_flush_done = 0;
+    __atomic_store_n(&g_running, 1, __ATOMIC_RELEASE);
+
+    if (pthread_create(&g_thread, NULL, logger_thread_main, NULL) != 0)
+    {
+        __atomic_store_n(&g_running, 0, __ATOMIC_RELEASE);
+        if (g_fd != STDERR_FILENO)
+        {
+            close(g_fd);
+        }
+        g_fd = -1;
+        return -1;
+    }
+
+    return 0;
+}
+
+void logger_shutdown(void)
+{
+    if (!g_running)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&g_flush_mutex);
+    __atomic_store_n(&g_running, 0, __ATOMIC_RELEASE);
+    ++g_flush_req;
+    pthread_cond_broadcast(&g_flush_cond);
+    pthread_mutex_unlock(&g_flush_mutex);
+
+    pthread_join(g_thread, NULL);
+
+    pthread_mutex_lock(&g_drain_mutex);
+    drain_all();
+    pthread_mutex_unlock(&g_drain_mutex);
+
+    // 仍在运行的线程可能正在写自己的缓存区，只标记为 ORPHANED，缓存区交给所属线程释放
+    pthread_mutex_lock(&g_mutex);
+    for (int i = 0; i < LOGGER_MAX_THREADS; ++i)
+    {
+        log_thread_t *thread = g_threads[i];
+        if (!thread)
+        {
+            continue;
+        }
+        g_threads[i] = nullptr;
+        if (__atomic_exchange_n(&thread->state, LOG_THREAD_ORPHANED, __ATOMIC_ACQ_REL) == LOG_THREAD_CLOSED)
+        {
+            ringbuffer_spsc_destroy(thread->rb);
+            free(thread);
+        }
+    }
+    pthread_mutex_unlock(&g_mutex);
+
+    if (g_fd != STDERR_FILENO)
+    {
+        close(g_fd);
+    }
+    g_fd = -1;
+}
+
+void logger_set_level(log_level_t level)
+{
+    logger_level = level;
+}
+
+void logger_flush(void)
+{
+    if (!__atomic_load_n(&g_running, __ATOMIC_ACQUIRE))
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&g_flush_mutex);
+    uint64_t req = ++g_flush_req;
+    pthread_cond_broadcast(&g_flush_cond);
+    while (g_flush_done < req && g_running)
+    {
+        pthread_cond_wait(&g_flush_cond, &g_flush_mutex);
+    }
+    pthread_mutex_unlock(&g_flush_mutex);
+}
+
+uint64_t logger_dropped(void)
+{
+    return __atomic_load_n(&g_dropped, __ATOMIC_RELAXED);
+}
+
+void logger_crash_flush(void)
+{
+    if (g_fd < 0)
+    {
+        return;
+    }
+
+    // 崩溃的是后台线程本身时它就是唯一的读取方，可能停在 drain_all 中间，不等锁直接读取
+    if (t_drain_thread)
+    {
+        drain_all();
+        return;
+    }
+
+    // 其他线程必须拿到 g_drain_mutex 才能读，否则会和后台线程同时消费同一个 SPSC 缓存、共用 stage/out。
+    // 后台线程可能正在写，最多等100ms，拿不到就放弃写出
+    struct timespec ts = {0, 1000000};
+    for (int i = 0; i < 100; ++i)
+    {
+        if (pthread_mutex_trylock(&g_drain_mutex) == 0)
+        {
+            drain_all();
+            pthread_mutex_unlock(&g_drain_mutex);
+            return;
+        }
+        nanosleep(&ts, NULL);
+    }
+}
+
+static void crash_handler(int sig)
+{
+    logger_crash_flush();
+    raise(sig);
+}
+
+int logger_install_crash_handler(void)
+{
+    static const int signals[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+    struct sigaction sa;
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = crash_handler;
+    sa.sa_flags = SA_RESETHAND | SA_NODEFER;
+    sigemptyset(&sa.sa_mask);
+
+    for (size_t i = 0; i < sizeof(signals) / sizeof(signals[0]); ++i)
+    {
+        if (sigaction(signals[i], &sa, NULL) != 0)
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
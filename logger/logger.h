@@ -0,0 +1,139 @@
+#ifndef __LOGGER_H__
+#define __LOGGER_H__
+
+#include <stdint.h>
+#include <stdarg.h>
+
+#define LOGGER_MAX_FORMATS      4096    //最多注册的格式串数量
+#define LOGGER_MAX_THREADS      256     //最多同时写日志的线程数量
+#define LOGGER_MAX_RECORD       1024    //单条记录最大字节数，超长的字符串参数会被截断
+#define LOGGER_DEFAULT_BUFFER   (256 * 1024)
+
+/**
+/*@brief 日志级别
+/*
+*/
+typedef enum log_level_t
+{
+    LOG_LEVEL_DEBUG,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_ERROR,
+} log_level_t;
+
+/**
+/*@brief 线程缓存区满时的处理策略
+/*
+*/
+typedef enum logger_policy_t
+{
+    LOGGER_POLICY_DROP,     //丢弃该条日志并计数，写日志永不阻塞
+    LOGGER_POLICY_BLOCK,    //阻塞等待后台线程腾出空间，不丢日志
+} logger_policy_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern volatile int logger_level;
+
+/**
+/*@brief 初始化日志并启动后台写线程
+/*
+/* 每个线程第一次写日志时创建自己的 ringbuffer_spsc，只有该线程写、后台线程读，写日志不加锁。
+/* 记录为二进制格式：格式串编号 + 时间戳 + 原始参数，格式化和 writev 都在后台线程完成。
+/*
+/*@param path 日志文件路径，NULL 表示标准错误
+/*@param buffer_size 每个线程的缓存区大小，0 表示 LOGGER_DEFAULT_BUFFER
+/*@param policy 缓存区满时的处理策略
+/*@return int 成功返回0，失败返回-1
+*/
+int logger_init(const char *path, uint32_t buffer_size, logger_policy_t policy);
+
+/**
+/*@brief 写出全部日志并停止后台线程
+/*
+/* 可以在其他线程仍在写日志时调用：之后写入的日志会被丢弃并计入 logger_dropped，
+/* BLOCK 策略下等待空间的线程也会返回。各线程的缓存区由所属线程退出时释放。
+*/
+void logger_shutdown(void);
+
+/**
+/*@brief 设置最低输出级别
+/*
+/*@param level 日志级别
+*/
+void logger_set_level(log_level_t level);
+
+/**
+/*@brief 等待调用前写入的日志全部写到文件
+/*
+*/
+void logger_flush(void);
+
+/**
+/*@brief 获取因缓存区满被丢弃的日志条数
+/*
+/*@return uint64_t 丢弃条数
+*/
+uint64_t logger_dropped(void);
+
+/**
+/*@brief 安装崩溃处理，SIGSEGV/SIGBUS/SIGFPE/SIGILL/SIGABRT 时先写出缓存中的日志再按默认方式退出
+/*
+/*@return int 成功返回0
+*/
+int logger_install_crash_handler(void);
+
+/**
+/*@brief 在当前线程同步写出全部缓存中的日志，供自定义的崩溃处理调用
+/*
+/* 尽力而为：在后台线程里调用时直接读取；其他线程最多等待后台线程100ms，
+/* 等不到读取权就不写出，避免和后台线程同时读取。格式化过程不是异步信号安全的
+*/
+void logger_crash_flush(void);
+
+/**
+/*@brief 注册格式串，由 LOG_* 宏在每个调用点第一次执行时调用
+/*
+/* 支持 printf 的整数、浮点、字符、字符串、指针转换及长度修饰，不支持 * 宽度和 %n
+/*
+/*@return uint32_t 格式串编号，失败返回0
+*/
+uint32_t logger_register_format(log_level_t level, const char *file, int line, const char *fmt);
+
+/**
+/*@brief 按格式串编号写入一条日志，由 LOG_* 宏调用
+/*
+*/
+void logger_write(uint32_t fmt_id, ...);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define LOG_WRITE(level, fmt, ...)                                                      \
+    do                                                                                  \
+    {                                                                                   \
+        if ((level) >= logger_level)                                                    \
+        {                                                                               \
+            static uint32_t __log_fmt_id = 0;                                           \
+            uint32_t __id = __atomic_load_n(&__log_fmt_id, __ATOMIC_ACQUIRE);           \
+            if (__id == 0)                                                              \
+            {                                                                           \
+                __id = logger_register_format((level), __FILE__, __LINE__, (fmt));      \
+                __atomic_store_n(&__log_fmt_id, __id, __ATOMIC_RELEASE);                \
+            }                                                                           \
+            if (__id != 0)                                                              \
+            {                                                                           \
+                logger_write(__id, ##__VA_ARGS__);                                      \
+            }                                                                           \
+        }                                                                               \
+    } while (0)
+
+#define LOG_DEBUG(fmt, ...) LOG_WRITE(LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+#define LOG_INFO(fmt, ...)  LOG_WRITE(LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#define LOG_WARN(fmt, ...)  LOG_WRITE(LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+#define LOG_ERROR(fmt, ...) LOG_WRITE(LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+
+#endif /* __LOGGER_H__ */
@@ -0,0 +1,638 @@
+#include "reactor.h"
+#include "RingBufferIo.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/sysinfo.h>
+
+typedef struct reactor_loop_t reactor_loop_t;
+
+/**
+/*@brief 连接
+/*
+/* busy 为1时 in/out 和 close_requested/out_blocked 归正在执行的 on_data 所有，
+/* 事件循环只记录事件 (read_pending)，等解码完成交回后再处理
+*/
+struct reactor_conn_t
+{
+    struct list_head      node;             //挂在所属事件循环的连接链表上
+    struct mpsc_node      done_node;        //解码完成后挂在事件循环的完成队列上
+    reactor_loop_t        *loop;
+    int                   fd;
+    ringbuffer            *in;              //接收缓存区
+    ringbuffer            *out;             //发送缓存区
+    uint64_t              in_total;         //累计接收字节数
+    uint64_t              in_decoded;       //上次解码开始时的 in_total
+    int                   busy;             //on_data 正在执行
+    int                   read_pending;     //解码期间收到可读事件或接收缓存区已满，解码完成后需要再读
+    int                   out_blocked;      //reactor_send 因空间不足失败，发送缓存区写出数据后需要再解码
+    int                   out_progress;     //上次解码后发送缓存区有数据写出
+    int                   peer_closed;      //对端关闭
+    int                   error;            //读写出错
+    int                   close_requested;  //on_data 请求关闭
+    void                  *context;
+};
+
+/**
+/*@brief 事件循环
+/*
+*/
+struct reactor_loop_t
+{
+    reactor_t             *reactor;
+    int                   index;
+    int                   epfd;
+    int                   listen_fd;
+    int                   event_fd;         //线程池完成解码后唤醒事件循环
+    int                   wakeup_pending;   //已写 eventfd 还未被事件循环读取，避免重复写
+    int                   busy_num;         //正在线程池中解码的连接数量，只由事件循环修改
+    int                   task_num;         //还未返回的解码任务数量，任务写完 eventfd 后才减一
+    struct mpsc_head      done;             //解码完成的连接
+    struct list_head      conns;
+    pthread_t             thread;
+};
+
+struct reactor_t
+{
+    reactor_config_t      config;
+    int                   loop_num;
+    reactor_loop_t        *loops;
+    uint16_t              port;
+    volatile int          stop;
+};
+
+static void conn_process(reactor_conn_t *conn);
+
+/**
+/*@brief 创建监听 socket，所有事件循环绑定同一端口，由 SO_REUSEPORT 在内核中分发连接
+/*
+*/
+static int create_listen_socket(const char *host, uint16_t port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (!host || inet_pton(AF_INET, host, &addr.sin_addr) != 1)
+    {
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    }
+
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, SOMAXCONN) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+static reactor_conn_t *conn_create(reactor_loop_t *loop, int fd)
+{
+    const reactor_config_t *config = &loop->reactor->config;
+    reactor_conn_t *conn = (reactor_conn_t *)calloc(1, sizeof(reactor_conn_t));
+    if (!conn)
+    {
+        return NULL;
+    }
+
+    conn->loop = loop;
+    conn->fd = fd;
+    conn->in = ringbuffer_create(config->in_buffer_size);
+    conn->out = ringbuffer_create(config->out_buffer_size);
+    if (!conn->in || !conn->out)
+    {
+        if (conn->in) ringbuffer_destroy(conn->in);
+        if (conn->out) ringbuffer_destroy(conn->out);
+        free(conn);
+        return NULL;
+    }
+
+    return conn;
+}
+
+/**
+/*@brief 关闭连接并释放，只能在事件循环线程且连接不在解码时调用
+/*
+*/
+static void conn_close(reactor_conn_t *conn)
+{
+    reactor_loop_t *loop = conn->loop;
+    const reactor_config_t *config = &loop->reactor->config;
+
+    epoll_ctl(loop->epfd, EPOLL_CTL_DEL, conn->fd, NULL);
+    close(conn->fd);
+    list_delete_entry(&conn->node);
+
+    if (config->handler.on_close)
+    {
+        config->handler.on_close(conn, config->user);
+    }
+
+    ringbuffer_destroy(conn->in);
+    ringbuffer_destroy(conn->out);
+    free(conn);
+}
+
+/**
+/*@brief 边沿触发，读到 EAGAIN 为止；接收缓存区满时先停止，解码腾出空间后再读
+/*
+*/
+static void conn_read(reactor_conn_t *conn)
+{
+    while (true)
+    {
+        ssize_t ret = ringbuffer_read_fd(conn->in, conn->fd, UINT32_MAX);
+        if (ret > 0)
+        {
+            conn->in_total += ret;
+            continue;
+        }
+        if (ret == 0)
+        {
+            conn->peer_closed = 1;
+        }
+        else if (errno == ENOBUFS)
+        {
+            conn->read_pending = 1;
+        }
+        else if (errno == EINTR)
+        {
+            continue;
+        }
+        else if (errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+            conn->error = 1;
+        }
+        break;
+    }
+}
+
+/**
+/*@brief 把发送缓存区中的全部回复用 writev 写出，写不完时等待 EPOLLOUT
+/*
+*/
+static void conn_flush(reactor_conn_t *conn)
+{
+    while (ringbuffer_data_len(conn->out) > 0)
+    {
+        ssize_t ret = ringbuffer_write_fd(conn->out, conn->fd, UINT32_MAX);
+        if (ret > 0)
+        {
+            conn->out_progress = 1;
+            continue;
+        }
+        if (ret < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (ret < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+            conn->error = 1;
+        }
+        break;
+    }
+}
+
+static void conn_decode(reactor_conn_t *conn)
+{
+    const reactor_config_t *config = &conn->loop->reactor->config;
+    config->handler.on_data(conn, conn->in, config->user);
+}
+
+/**
+/*@brief 线程池任务：解码后把连接放回事件循环的完成队列
+/*
+*/
+static void conn_decode_task(void *args)
+{
+    reactor_conn_t *conn = (reactor_conn_t *)args;
+    reactor_loop_t *loop = conn->loop;
+
+    conn_decode(conn);
+
+    // 入队后连接可能马上被事件循环关闭，之后只能访问 loop；
+    // task_num 归零前事件循环不会退出，loop 和 eventfd 保持有效
+    mpsc_push(&loop->done, &conn->done_node);
+    if (!__atomic_exchange_n(&loop->wakeup_pending, 1, __ATOMIC_ACQ_REL))
+    {
+        uint64_t one = 1;
+        ssize_t ret = write(loop->event_fd, &one, sizeof(one));
+        (void)ret;
+    }
+    __atomic_sub_fetch(&loop->task_num, 1, __ATOMIC_RELEASE);
+}
+
+/**
+/*@brief 在事件循环线程推进连接状态：读数据、提交解码、写回复、关闭
+/*
+*/
+static void conn_process(reactor_conn_t *conn)
+{
+    threadpool_t *pool = conn->loop->reactor->config.pool;
+
+    while (true)
+    {
+        conn_flush(conn);           //先写出上次解码的回复，腾出发送缓存区
+        if (conn->error)
+        {
+            break;
+        }
+
+        if (conn->read_pending)
+        {
+            conn->read_pending = 0;
+            conn_read(conn);
+        }
+
+        // 有新数据，或者上次因发送缓存区满而中断且之后写出了数据，才需要再解码
+        bool has_work = conn->in_total != conn->in_decoded || (conn->out_blocked && conn->out_progress);
+        if (!has_work || conn->error)
+        {
+            break;
+        }
+
+        conn->in_decoded = conn->in_total;
+        conn->out_blocked = 0;
+        conn->out_progress = 0;
+        conn->busy = 1;
+
+        if (pool)
+        {
+            __atomic_add_fetch(&conn->loop->task_num, 1, __ATOMIC_RELAXED);
+            if (add_task_threadpool(pool, conn_decode_task, conn, 0) == 0)
+            {
+                ++conn->loop->busy_num;
+                return;             //解码完成后由 conn_complete 继续
+            }
+            __atomic_sub_fetch(&conn->loop->task_num, 1, __ATOMIC_RELAXED);
+        }
+
+        conn_decode(conn);          //没有线程池或任务已满，在当前线程解码
+        conn->busy = 0;
+    }
+
+    if (conn->error || ((conn->peer_closed || conn->close_requested) && ringbuffer_data_len(conn->out) == 0))
+    {
+        conn_close(conn);
+    }
+}
+
+/**
+/*@brief 线程池解码完成，连接交回事件循环
+/*
+*/
+static void conn_complete(reactor_conn_t *conn)
+{
+    --conn->loop->busy_num;
+    conn->busy = 0;
+    conn_process(conn);
+}
+
+static void loop_accept(reactor_loop_t *loop)
+{
+    const reactor_config_t *config = &loop->reactor->config;
+
+    while (true)
+    {
+        int fd = accept4(loop->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+            {
+                continue;
+            }
+            break;      //EAGAIN，或文件描述符耗尽时等下次可读再试
+        }
+
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+        reactor_conn_t *conn = conn_create(loop, fd);
+        if (!conn)
+        {
+            close(fd);
+            continue;
+        }
+
+        struct epoll_event ev;
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.ptr = conn;
+        if (epoll_ctl(loop->epfd, EPOLL_CTL_ADD, fd, &ev) < 0)
+        {
+            close(fd);
+            ringbuffer_destroy(conn->in);
+            ringbuffer_destroy(conn->out);
+            free(conn);
+            continue;
+        }
+        list_add_tail(&conn->node, &loop->conns);
+
+        if (config->handler.on_open)
+        {
+            config->handler.on_open(conn, config->user);
+        }
+    }
+}
+
+/**
+/*@brief 取出全部解码完成的连接
+/*
+/* 先清除 wakeup_pending 再取队列：清除之后入队的线程会重新写 eventfd，不会漏掉
+*/
+static void loop_drain_done(reactor_loop_t *loop)
+{
+    uint64_t value;
+    ssize_t ret = read(loop->event_fd, &value, sizeof(value));
+    (void)ret;
+    __atomic_exchange_n(&loop->wakeup_pending, 0, __ATOMIC_ACQ_REL);
+
+    struct mpsc_node *node;
+    while ((node = mpsc_pop(&loop->done)) != NULL)
+    {
+        conn_complete(list_entry(node, reactor_conn_t, done_node));
+    }
+}
+
+static void *loop_thread(void *args)
+{
+    reactor_loop_t *loop = (reactor_loop_t *)args;
+    reactor_t *reactor = loop->reactor;
+    struct epoll_event events[REACTOR_MAX_EVENTS];
+
+    while (!reactor->stop || loop->busy_num > 0)
+    {
+        int n = epoll_wait(loop->epfd, events, REACTOR_MAX_EVENTS, -1);
+        bool done = false;
+
+        for (int i = 0; i < n; ++i)
+        {
+            void *ptr = events[i].data.ptr;
+            if (ptr == &loop->listen_fd)
+            {
+                loop_accept(loop);
+                continue;
+            }
+            if (ptr == &loop->event_fd)
+            {
+                done = true;    //处理完本批事件再取完成队列，避免本批后面的事件引用已关闭的连接
+                continue;
+            }
+
+            reactor_conn_t *conn = (reactor_conn_t *)ptr;
+            if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+            {
+                conn->read_pending = 1;
+            }
+            if (conn->busy)
+            {
+                continue;       //解码完成后统一处理
+            }
+            if (events[i].events & EPOLLOUT)
+            {
+                conn_flush(conn);
+            }
+            conn_process(conn);
+        }
+
+        if (done)
+        {
+            loop_drain_done(loop);
+        }
+
+        if (reactor->stop && loop->listen_fd >= 0)
+        {
+            epoll_ctl(loop->epfd, EPOLL_CTL_DEL, loop->listen_fd, NULL);
+            close(loop->listen_fd);
+            loop->listen_fd = -1;
+        }
+    }
+
+    // 最后一个连接已经交回，但它的任务可能还在写 eventfd，等任务全部返回后 loop 才能释放
+    while (__atomic_load_n(&loop->task_num, __ATOMIC_ACQUIRE) > 0)
+    {
+        sched_yield();
+    }
+
+    while (!list_empty(&loop->conns))
+    {
+        conn_close(list_entry(loop->conns.next_ptr, reactor_conn_t, node));
+    }
+
+    return NULL;
+}
+
+static int loop_init(reactor_t *reactor, reactor_loop_t *loop, int index)
+{
+    loop->reactor = reactor;
+    loop->index = index;
+    loop->listen_fd = -1;
+    loop->event_fd = -1;
+    init_list_head(&loop->conns);
+    init_mpsc_head(&loop->done);
+
+    loop->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (loop->epfd < 0)
+    {
+        return -1;
+    }
+
+    loop->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    loop->listen_fd = create_listen_socket(reactor->config.host, reactor->port);
+    if (loop->event_fd < 0 || loop->listen_fd < 0)
+    {
+        return -1;
+    }
+
+    // 端口为0时第一个监听 socket 由系统分配端口，其余循环绑定同一端口
+    if (reactor->port == 0)
+    {
+        struct sockaddr_in addr;
+        socklen_t len = sizeof(addr);
+        getsockname(loop->listen_fd, (struct sockaddr *)&addr, &len);
+        reactor->port = ntohs(addr.sin_port);
+    }
+
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLET;
+    ev.data.ptr = &loop->listen_fd;
+    if (epoll_ctl(loop->epfd, EPOLL_CTL_ADD, loop->listen_fd, &ev) < 0)
+    {
+        return -1;
+    }
+    ev.events = EPOLLIN | EPOLLET;
+    ev.data.ptr = &loop->event_fd;
+    if (epoll_ctl(loop->epfd, EPOLL_CTL_ADD, loop->event_fd, &ev) < 0)
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+static void loop_release(reactor_loop_t *loop)
+{
+    if (loop->listen_fd >= 0) close(loop->listen_fd);
+    if (loop->event_fd >= 0) close(loop->event_fd);
+    if (loop->epfd >= 0) close(loop->epfd);
+}
+
+static void loop_wakeup(reactor_loop_t *loop)
+{
+    uint64_t one = 1;
+    ssize_t ret = write(loop->event_fd, &one, sizeof(one));
+    (void)ret;
+}
+
+reactor_t *reactor_create(const reactor_config_t *config)
+{
+    if (!config || !config->handler.on_data)
+    {
+        printf("reactor on_data is NULL\n");
+        return NULL;
+    }
+
+    reactor_t *reactor = (reactor_t *)calloc(1, sizeof(reactor_t));
+    if (!reactor)
+    {
+        printf("malloc reactor_t fail\n");
+        return NULL;
+    }
+
+    reactor->config = *config;
+    if (reactor->config.in_buffer_size == 0) reactor->config.in_buffer_size = REACTOR_DEFAULT_BUFFER;
+    if (reactor->config.out_buffer_size == 0) reactor->config.out_buffer_size = REACTOR_DEFAULT_BUFFER;
+    reactor->loop_num = config->loop_num > 0 ? config->loop_num : get_nprocs();
+    reactor->port = config->port;
+
+    reactor->loops = (reactor_loop_t *)calloc(reactor->loop_num, sizeof(reactor_loop_t));
+    if (!reactor->loops)
+    {
+        printf("malloc reactor loops fail\n");
+        free(reactor);
+        return NULL;
+    }
+    for (int i = 0; i < reactor->loop_num; ++i)
+    {
+        reactor->loops[i].epfd = -1;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+
+    for (int i = 0; i < reactor->loop_num; ++i)
+    {
+        if (loop_init(reactor, &reactor->loops[i], i) < 0)
+        {
+            printf("reactor listen on port %u fail: %s\n", reactor->port, strerror(errno));
+            for (int j = 0; j <= i; ++j)
+            {
+                loop_release(&reactor->loops[j]);
+            }
+            free(reactor->loops);
+            free(reactor);
+            return NULL;
+        }
+    }
+
+    int cpus = get_nprocs();
+    for (int i = 0; i < reactor->loop_num; ++i)
+    {
+        reactor_loop_t *loop = &reactor->loops[i];
+        pthread_create(&loop->thread, NULL, loop_thread, loop);
+
+        if (config->pin_cpu)
+        {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(i % cpus, &set);
+            pthread_setaffinity_np(loop->thread, sizeof(set), &set);
+        }
+    }
+
+    return reactor;
+}
+
+void reactor_destroy(reactor_t *reactor)
+{
+    if (!reactor)
+    {
+        return;
+    }
+
+    reactor->stop = 1;
+    for (int i = 0; i < reactor->loop_num; ++i)
+    {
+        loop_wakeup(&reactor->loops[i]);
+    }
+    for (int i = 0; i < reactor->loop_num; ++i)
+    {
+        pthread_join(reactor->loops[i].thread, NULL);
+        loop_release(&reactor->loops[i]);
+    }
+
+    free(reactor->loops);
+    free(reactor);
+}
+
+uint16_t reactor_port(reactor_t *reactor)
+{
+    return reactor ? reactor->port : 0;
+}
+
+int reactor_send(reactor_conn_t *conn, const void *data, uint32_t length)
+{
+    ringbuffer *out = conn->out;
+    if (ringbuffer_get_size(out) - ringbuffer_data_len(out) < length)
+    {
+        conn->out_blocked = 1;
+        return -1;
+    }
+
+    ringbuffer_put(out, (uint8_t *)data, length);
+    return 0;
+}
+
+void reactor_conn_close(reactor_conn_t *conn)
+{
+    conn->close_requested = 1;
+}
+
+int reactor_conn_fd(reactor_conn_t *conn)
+{
+    return conn->fd;
+}
+
+void *reactor_conn_get_context(reactor_conn_t *conn)
+{
+    return conn->context;
+}
+
+void reactor_conn_set_context(reactor_conn_t *conn, void *context)
+{
+    conn->context = context;
+}
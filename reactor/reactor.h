@@ -0,0 +1,110 @@
+#ifndef __REACTOR_H__
+#define __REACTOR_H__
+
+#include <stdint.h>
+#include "RingBuffer.h"
+#include "threadpool.h"
+
+#define REACTOR_DEFAULT_BUFFER  (64 * 1024)     //每个连接收发缓存区的默认大小
+#define REACTOR_MAX_EVENTS      256             //每次 epoll_wait 最多取出的事件数量
+
+typedef struct reactor_t reactor_t;
+typedef struct reactor_conn_t reactor_conn_t;
+
+/**
+/*@brief 连接事件回调
+/*
+/* on_open/on_close 在连接所属的事件循环线程调用。
+/* on_data 在线程池线程调用 (未配置线程池或线程池任务已满时在事件循环线程调用)，
+/* 同一连接同一时刻只有一个 on_data 在执行，in 中是已收到但还未被消费的数据，
+/* 回调解出完整的消息后用 ringbuffer_consume/ringbuffer_get 消费，不完整的部分留到下次。
+*/
+typedef struct reactor_handler_t
+{
+    void (*on_open)(reactor_conn_t *conn, void *user);                  //可为NULL
+    void (*on_data)(reactor_conn_t *conn, ringbuffer *in, void *user);
+    void (*on_close)(reactor_conn_t *conn, void *user);                 //可为NULL
+} reactor_handler_t;
+
+/**
+/*@brief 创建参数
+/*
+*/
+typedef struct reactor_config_t
+{
+    const char            *host;            //监听地址，NULL 表示 0.0.0.0
+    uint16_t              port;             //监听端口，0 表示由系统分配，用 reactor_port 获取
+    int                   loop_num;         //事件循环数量，0 表示每个CPU一个
+    int                   pin_cpu;          //非0时第 i 个事件循环绑定到第 i 个CPU
+    uint32_t              in_buffer_size;   //每个连接接收缓存区大小，0 表示 REACTOR_DEFAULT_BUFFER
+    uint32_t              out_buffer_size;  //每个连接发送缓存区大小，0 表示 REACTOR_DEFAULT_BUFFER
+    threadpool_t          *pool;            //执行 on_data 的线程池，NULL 表示在事件循环线程执行
+    reactor_handler_t     handler;
+    void                  *user;            //传给回调的用户参数
+} reactor_config_t;
+
+/**
+/*@brief 创建多事件循环服务器并开始监听
+/*
+/* 每个事件循环一个线程、一个 epoll 和一个设置了 SO_REUSEPORT 的监听 socket，由内核把新连接分散到各个循环，
+/* 连接建立后只由所属循环处理。连接以边沿触发注册，可读时用一次 readv 直接读入连接的接收 ringbuffer，
+/* 然后把解码交给线程池；解码期间接收和发送缓存区归 on_data 所有，事件循环不读写它们，
+/* 解码完成后通过无锁队列和 eventfd 交回事件循环，一批回复用一次 writev 写出。
+/* 创建时会忽略 SIGPIPE。
+/*
+/*@param config 创建参数
+/*@return reactor_t* 失败返回NULL
+*/
+reactor_t *reactor_create(const reactor_config_t *config);
+
+/**
+/*@brief 停止事件循环，关闭所有连接和监听 socket
+/*
+/* 等待正在线程池中执行的 on_data 返回，线程池需要在此之后销毁
+/*
+/*@param reactor 服务器句柄
+*/
+void reactor_destroy(reactor_t *reactor);
+
+/**
+/*@brief 获取实际监听的端口
+/*
+/*@param reactor 服务器句柄
+/*@return uint16_t 端口
+*/
+uint16_t reactor_port(reactor_t *reactor);
+
+/**
+/*@brief 追加回复数据到连接的发送缓存区，只能在该连接的 on_data 中调用
+/*
+/* 数据在 on_data 返回后与同一批的其他回复一起写出
+/*
+/*@param conn 连接
+/*@param data 数据
+/*@param length 长度
+/*@return int 成功返回0，发送缓存区空间不足返回-1 (不写入任何数据)，
+/*            此时 on_data 应停止解码并返回，缓存区腾出空间后会再次调用 on_data
+*/
+int reactor_send(reactor_conn_t *conn, const void *data, uint32_t length);
+
+/**
+/*@brief 请求在发送缓存区写完后关闭连接，只能在该连接的 on_data 中调用
+/*
+/*@param conn 连接
+*/
+void reactor_conn_close(reactor_conn_t *conn);
+
+/**
+/*@brief 获取连接的 socket
+/*
+*/
+int reactor_conn_fd(reactor_conn_t *conn);
+
+/**
+/*@brief 获取/设置连接的用户数据，用于保存协议解码状态
+/*
+*/
+void *reactor_conn_get_context(reactor_conn_t *conn);
+void reactor_conn_set_context(reactor_conn_t *conn, void *context);
+
+#endif /* __REACTOR_H__ */
@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "RingBuffer.h"
+#include "RingBuffer64.h"
+#include "RingBufferCopy.h"
+
+#ifndef MAX
+#define MAX(x, y) (((x) > (y)) ? (x) : (y))
+#endif
+
+#define BENCH_BUFFER_SIZE   (64 * 1024)
+#define BENCH_TOTAL_BYTES   (2ull * 1024 * 1024 * 1024)
+#define BENCH_PREFILL       (BENCH_BUFFER_SIZE / 3)
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void report(const char *name, uint32_t chunk, uint64_t bytes, uint64_t ns, uint64_t check)
+{
+    printf("%-14s chunk=%-6u %8.2f GB/s %8.2f ns/op (check=%llu)\n", name, chunk,
+           (double)bytes / ns, (double)ns / (bytes / chunk), (unsigned long long)check);
+}
+
+/**
+/*@brief 原 mirror 位实现：每轮写入一块，查询一次长度，再读出一块
+/*
+/*@param chunk 块大小
+*/
+static void bench_ringbuffer(uint32_t chunk)
+{
+    ringbuffer *rb = ringbuffer_create(BENCH_BUFFER_SIZE);
+    uint8_t *src = (uint8_t *)calloc(1, MAX(chunk, BENCH_PREFILL));   //预写入时也从 src 读取
+    uint8_t *dst = (uint8_t *)malloc(chunk);
+    uint64_t check = 0;
+
+    // 先写入一部分，使读写位置错开，覆盖回绕路径
+    ringbuffer_put(rb, src, BENCH_PREFILL);
+
+    uint64_t start = now_ns();
+    for (uint64_t done = 0; done < BENCH_TOTAL_BYTES; done += chunk)
+    {
+        ringbuffer_put(rb, src, chunk);
+        check += ringbuffer_data_len(rb);
+        ringbuffer_get(rb, dst, chunk);
+    }
+    report("ringbuffer", chunk, BENCH_TOTAL_BYTES, now_ns() - start, check);
+
+    free(src);
+    free(dst);
+    ringbuffer_destroy(rb);
+}
+
+/**
+/*@brief 64位计数、2的幂容量实现，操作序列与 bench_ringbuffer 相同
+/*
+/*@param chunk 块大小
+*/
+static void bench_ringbuffer64(uint32_t chunk)
+{
+    ringbuffer64 *rb = ringbuffer64_create(BENCH_BUFFER_SIZE);
+    uint8_t *src = (uint8_t *)calloc(1, MAX(chunk, BENCH_PREFILL));   //预写入时也从 src 读取
+    uint8_t *dst = (uint8_t *)malloc(chunk);
+    uint64_t check = 0;
+
+    ringbuffer64_put(rb, src, BENCH_PREFILL);
+
+    uint64_t start = now_ns();
+    for (uint64_t done = 0; done < BENCH_TOTAL_BYTES; done += chunk)
+    {
+        ringbuffer64_put(rb, src, chunk);
+        check += ringbuffer64_data_len(rb);
+        ringbuffer64_get(rb, dst, chunk);
+    }
+    report("ringbuffer64", chunk, BENCH_TOTAL_BYTES, now_ns() - start, check);
+
+    free(src);
+    free(dst);
+    ringbuffer64_destroy(rb);
+}
+
+int main(void)
+{
+    uint32_t chunks[] = {8, 64, 512, 4096, 16384};
+
+    // 两种 ringbuffer 都用 ringbuffer_copy 拷贝，差别只在下标布局
+    printf("copy isa: %s\n", ringbuffer_copy_isa());
+
+    for (size_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); ++i)
+    {
+        bench_ringbuffer(chunks[i]);
+        bench_ringbuffer64(chunks[i]);
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include <string>
+#include <vector>
+#include "Histogram.h"
+
+/**
+/*@brief 命令行选项
+/*
+*/
+struct BenchOptions
+{
+    std::vector<int> cpus;      //绑核列表，线程按创建顺序轮流绑定，为空时不绑核
+    uint64_t ops = 200000;      //每个配置的操作数量
+    bool quick = false;         //只跑一组较小的矩阵
+};
+
+/**
+/*@brief 一组配置的测试结果
+/*
+*/
+struct BenchResult
+{
+    std::string bench;          //测试对象
+    std::string metric;         //延迟的含义，例如 submit_to_start
+    std::string config;         //配置，key=value 以空格分隔
+    int threads = 0;
+    uint64_t ops = 0;
+    uint64_t bytes = 0;
+    double seconds = 0;
+    Histogram latency;          //纳秒
+};
+
+static inline uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/**
+/*@brief 按选项把线程绑定到第 index 个CPU
+/*
+*/
+static inline void bench_pin(pthread_t thread, const BenchOptions &opt, int index)
+{
+    if (opt.cpus.empty())
+    {
+        return;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(opt.cpus[index % opt.cpus.size()], &set);
+    pthread_setaffinity_np(thread, sizeof(set), &set);
+}
+
+void bench_threadpool(const BenchOptions &opt, std::vector<BenchResult> &results);
+void bench_blockqueue(const BenchOptions &opt, std::vector<BenchResult> &results);
+void bench_ringbuffer(const BenchOptions &opt, std::vector<BenchResult> &results);
+
+#endif /* __BENCH_H__ */
@@ -0,0 +1,143 @@
+#include <sched.h>
+#include <thread>
+#include "Bench.h"
+#include "BlockQueue.h"
+
+typedef BlockQueue<uint64_t> bench_queue_t;
+
+/**
+/*@brief 一组生产者/消费者共享的状态，元素为入队时的时间戳
+/*
+*/
+struct bq_context
+{
+    bench_queue_t *queue;
+    uint64_t total;
+    size_t batch;
+    uint64_t consumed;
+};
+
+static void bq_producer(bq_context *ctx, uint64_t count)
+{
+    if (ctx->batch == 1)
+    {
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            uint64_t item = bench_now_ns();
+            ctx->queue->push(item);
+        }
+        return;
+    }
+
+    std::vector<uint64_t> items;
+    for (uint64_t i = 0; i < count; i += items.size())
+    {
+        size_t n = (size_t)std::min<uint64_t>(ctx->batch, count - i);
+        items.assign(n, bench_now_ns());
+        ctx->queue->push_batch(items);
+    }
+}
+
+static void bq_consumer(bq_context *ctx, Histogram *latency)
+{
+    if (ctx->batch == 1)
+    {
+        uint64_t item;
+        while (ctx->queue->pop(item))
+        {
+            latency->record(bench_now_ns() - item);
+            if (__atomic_add_fetch(&ctx->consumed, 1, __ATOMIC_RELAXED) == ctx->total)
+            {
+                ctx->queue->close();    //最后一个元素出队后关闭队列，唤醒阻塞在 pop 的其他消费者
+            }
+        }
+        return;
+    }
+
+    //pop_batch 不阻塞，取不到时让出CPU
+    std::vector<uint64_t> items;
+    while (__atomic_load_n(&ctx->consumed, __ATOMIC_RELAXED) < ctx->total)
+    {
+        size_t n = ctx->queue->pop_batch(items, ctx->batch);
+        if (n == 0)
+        {
+            sched_yield();
+            continue;
+        }
+
+        uint64_t now = bench_now_ns();
+        for (uint64_t item : items)
+        {
+            latency->record(now - item);
+        }
+        __atomic_add_fetch(&ctx->consumed, n, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+/*@brief 测试一组生产者数量、消费者数量、批量大小的组合
+/*
+*/
+static void bench_blockqueue_once(const BenchOptions &opt, int producers, int consumers, size_t batch,
+                                  std::vector<BenchResult> &results)
+{
+    const size_t capacity = 1024;
+    bench_queue_t queue(capacity);
+    bq_context ctx = {&queue, opt.ops, batch, 0};
+    std::vector<Histogram> latency(consumers);
+    std::vector<std::thread> threads;
+
+    uint64_t begin = bench_now_ns();
+    for (int i = 0; i < consumers; ++i)
+    {
+        threads.push_back(std::thread(bq_consumer, &ctx, &latency[i]));
+        bench_pin(threads.back().native_handle(), opt, producers + i);
+    }
+    for (int i = 0; i < producers; ++i)
+    {
+        uint64_t count = opt.ops / producers + (i < (int)(opt.ops % producers) ? 1 : 0);
+        threads.push_back(std::thread(bq_producer, &ctx, count));
+        bench_pin(threads.back().native_handle(), opt, i);
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    uint64_t end = bench_now_ns();
+
+    BenchResult result;
+    char config[96];
+    snprintf(config, sizeof(config), "producers=%d consumers=%d batch=%zu capacity=%zu",
+             producers, consumers, batch, capacity);
+
+    result.bench = "blockqueue";
+    result.metric = "enqueue_to_dequeue";
+    result.config = config;
+    result.threads = producers + consumers;
+    result.ops = opt.ops;
+    result.bytes = opt.ops * sizeof(uint64_t);
+    result.seconds = (end - begin) / 1e9;
+    for (const Histogram &histogram : latency)
+    {
+        result.latency.merge(histogram);
+    }
+
+    results.push_back(result);
+}
+
+void bench_blockqueue(const BenchOptions &opt, std::vector<BenchResult> &results)
+{
+    std::vector<int> counts = opt.quick ? std::vector<int>{1, 2} : std::vector<int>{1, 2, 4};
+    std::vector<size_t> batches = opt.quick ? std::vector<size_t>{1, 16} : std::vector<size_t>{1, 16, 64};
+
+    for (int producers : counts)
+    {
+        for (int consumers : counts)
+        {
+            for (size_t batch : batches)
+            {
+                bench_blockqueue_once(opt, producers, consumers, batch, results);
+            }
+        }
+    }
+}
@@ -0,0 +1,102 @@
+#include <thread>
+#include "Bench.h"
+#include "RingBufferSpsc.h"
+
+#define RB_BENCH_BUFFER_SIZE    (1024 * 1024)
+#define RB_BENCH_MAX_BYTES      (256ull * 1024 * 1024)  //每个配置最多传输的字节数，避免大块时耗时过长
+
+/**
+/*@brief 生产者线程：每块开头写入当前时间戳，阻塞写入整块
+/*
+*/
+static void rb_producer(ringbuffer_spsc *rb, uint32_t chunk, uint64_t count)
+{
+    std::vector<uint8_t> src(chunk, 0x5a);
+
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        uint64_t now = bench_now_ns();
+        memcpy(src.data(), &now, sizeof(now));
+        ringbuffer_spsc_put_wait(rb, src.data(), chunk, -1);
+    }
+}
+
+/**
+/*@brief 消费者线程：读满一整块后用块开头的时间戳计算延迟
+/*
+*/
+static void rb_consumer(ringbuffer_spsc *rb, uint32_t chunk, uint64_t count, Histogram *latency)
+{
+    std::vector<uint8_t> dst(chunk);
+
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        uint32_t done = 0;
+        while (done < chunk)
+        {
+            done += ringbuffer_spsc_get_wait(rb, &dst[done], chunk - done, -1);
+        }
+
+        uint64_t stamp;
+        memcpy(&stamp, dst.data(), sizeof(stamp));
+        latency->record(bench_now_ns() - stamp);
+    }
+}
+
+/**
+/*@brief 测试一种块大小下 ringbuffer_spsc 跨线程的吞吐和写入到读出延迟
+/*
+/*@param chunk 块大小，不小于8字节
+*/
+static void bench_ringbuffer_once(const BenchOptions &opt, uint32_t chunk, std::vector<BenchResult> &results)
+{
+    ringbuffer_spsc *rb = ringbuffer_spsc_create(RB_BENCH_BUFFER_SIZE);
+    if (!rb)
+    {
+        return;
+    }
+
+    uint64_t count = opt.ops;
+    if (count * chunk > RB_BENCH_MAX_BYTES)
+    {
+        count = RB_BENCH_MAX_BYTES / chunk;
+    }
+
+    Histogram latency;
+    uint64_t begin = bench_now_ns();
+    std::thread consumer(rb_consumer, rb, chunk, count, &latency);
+    bench_pin(consumer.native_handle(), opt, 1);
+    std::thread producer(rb_producer, rb, chunk, count);
+    bench_pin(producer.native_handle(), opt, 0);
+    producer.join();
+    consumer.join();
+    uint64_t end = bench_now_ns();
+
+    ringbuffer_spsc_destroy(rb);
+
+    BenchResult result;
+    char config[64];
+    snprintf(config, sizeof(config), "chunk=%u buffer=%u", chunk, RB_BENCH_BUFFER_SIZE);
+
+    result.bench = "ringbuffer_spsc";
+    result.metric = "put_to_get";
+    result.config = config;
+    result.threads = 2;
+    result.ops = count;
+    result.bytes = count * chunk;
+    result.seconds = (end - begin) / 1e9;
+    result.latency = latency;
+
+    results.push_back(result);
+}
+
+void bench_ringbuffer(const BenchOptions &opt, std::vector<BenchResult> &results)
+{
+    std::vector<uint32_t> chunks = opt.quick ? std::vector<uint32_t>{64, 4096}
+                                             : std::vector<uint32_t>{64, 512, 4096, 65536};
+
+    for (uint32_t chunk : chunks)
+    {
+        bench_ringbuffer_once(opt, chunk, results);
+    }
+}
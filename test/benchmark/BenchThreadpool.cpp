@@ -0,0 +1,104 @@
+#include <unistd.h>
+#include "Bench.h"
+#include "threadpool.h"
+
+/**
+/*@brief 单个任务的时间戳，由提交线程和工作线程分别写入，结束后统一统计
+/*
+*/
+typedef struct tp_sample_t
+{
+    uint64_t submit;
+    uint64_t start;
+    uint64_t done;
+    volatile int *remain;
+} tp_sample_t;
+
+static void tp_task(void *args)
+{
+    tp_sample_t *sample = (tp_sample_t *)args;
+    sample->start = bench_now_ns();
+    sample->done = bench_now_ns();
+    __atomic_sub_fetch(sample->remain, 1, __ATOMIC_RELEASE);
+}
+
+/**
+/*@brief 单线程提交 ops 个空任务，记录提交到开始执行、提交到执行完成的延迟
+/*
+/*@param threads 线程池线程数量
+*/
+static void bench_threadpool_once(const BenchOptions &opt, int threads, std::vector<BenchResult> &results)
+{
+    const int max_task = 1024;
+    threadpool_t *pool = create_threadpool(threads, max_task);
+    if (!pool)
+    {
+        return;
+    }
+
+    bench_pin(pthread_self(), opt, 0);
+    for (int i = 0; i < threads; ++i)
+    {
+        bench_pin(pool->thread_ids[i], opt, i + 1);
+    }
+
+    std::vector<tp_sample_t> samples(opt.ops);
+    volatile int remain = (int)opt.ops;
+
+    uint64_t begin = bench_now_ns();
+    for (uint64_t i = 0; i < opt.ops; ++i)
+    {
+        tp_sample_t *sample = &samples[i];
+        sample->remain = &remain;
+        sample->submit = bench_now_ns();
+        while (add_task_threadpool(pool, tp_task, sample, 0) == -3)   //任务已满，让出CPU后重试
+        {
+            sched_yield();
+            sample->submit = bench_now_ns();
+        }
+    }
+    while (__atomic_load_n(&remain, __ATOMIC_ACQUIRE) > 0)
+    {
+        sched_yield();
+    }
+    uint64_t end = bench_now_ns();
+
+    destroy_threadpool(pool);
+
+    BenchResult start_result, done_result;
+    char config[64];
+    snprintf(config, sizeof(config), "workers=%d max_task=%d", threads, max_task);
+
+    start_result.bench = "threadpool";
+    start_result.metric = "submit_to_start";
+    start_result.config = config;
+    start_result.threads = threads + 1;
+    start_result.ops = opt.ops;
+    start_result.seconds = (end - begin) / 1e9;
+
+    done_result = start_result;
+    done_result.metric = "submit_to_complete";
+
+    for (const tp_sample_t &sample : samples)
+    {
+        start_result.latency.record(sample.start - sample.submit);
+        done_result.latency.record(sample.done - sample.submit);
+    }
+
+    results.push_back(start_result);
+    results.push_back(done_result);
+}
+
+void bench_threadpool(const BenchOptions &opt, std::vector<BenchResult> &results)
+{
+    static const int quick_threads[] = {2};
+    static const int full_threads[] = {1, 2, 4, 8};
+
+    const int *threads = opt.quick ? quick_threads : full_threads;
+    size_t count = opt.quick ? sizeof(quick_threads) / sizeof(int) : sizeof(full_threads) / sizeof(int);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        bench_threadpool_once(opt, threads[i], results);
+    }
+}
@@ -0,0 +1,108 @@
+#ifndef __HISTOGRAM_H__
+#define __HISTOGRAM_H__
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+/**
+/*@brief HdrHistogram 风格的对数-线性延迟直方图
+/*
+/* 小于 128 的值每个值一个桶；更大的值按 2 的幂分段，每段再线性分成 64 个子桶，
+/* 相对误差不超过 1/64 (约1.6%)，覆盖整个 uint64 范围，记录只是一次数组自增。
+/* 每个线程记录自己的直方图，结束后 merge 到一起。
+*/
+class Histogram
+{
+public:
+    Histogram() : m_counts(BUCKET_COUNT, 0), m_count(0), m_sum(0), m_min(UINT64_MAX), m_max(0) {}
+
+    void record(uint64_t value)
+    {
+        ++m_counts[index_of(value)];
+        ++m_count;
+        m_sum += value;
+        if (value < m_min) m_min = value;
+        if (value > m_max) m_max = value;
+    }
+
+    void merge(const Histogram &other)
+    {
+        for (size_t i = 0; i < BUCKET_COUNT; ++i)
+        {
+            m_counts[i] += other.m_counts[i];
+        }
+        m_count += other.m_count;
+        m_sum += other.m_sum;
+        if (other.m_min < m_min) m_min = other.m_min;
+        if (other.m_max > m_max) m_max = other.m_max;
+    }
+
+    /**
+    /*@brief 获取百分位值，返回所在桶的上界 (与 HdrHistogram 的 highest equivalent value 相同)
+    /*
+    /*@param percentile 0 ~ 100
+    */
+    uint64_t percentile(double percentile) const
+    {
+        if (m_count == 0)
+        {
+            return 0;
+        }
+
+        uint64_t target = (uint64_t)(percentile / 100.0 * m_count + 0.5);
+        if (target < 1) target = 1;
+        if (target > m_count) target = m_count;
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i)
+        {
+            seen += m_counts[i];
+            if (seen >= target)
+            {
+                uint64_t upper = upper_of(i);
+                return upper < m_max ? upper : m_max;
+            }
+        }
+        return m_max;
+    }
+
+    uint64_t count() const { return m_count; }
+    uint64_t min() const { return m_count ? m_min : 0; }
+    uint64_t max() const { return m_max; }
+    double mean() const { return m_count ? (double)m_sum / m_count : 0.0; }
+
+private:
+    static const int LINEAR_BITS = 7;                           //[0, 128) 线性
+    static const int SUB_BITS = LINEAR_BITS - 1;                //每段 64 个子桶
+    static const size_t BUCKET_COUNT = (1 << LINEAR_BITS) + (64 - LINEAR_BITS) * (1 << SUB_BITS);
+
+    static size_t index_of(uint64_t value)
+    {
+        if (value < (1u << LINEAR_BITS))
+        {
+            return (size_t)value;
+        }
+        int shift = 63 - __builtin_clzll(value) - SUB_BITS;
+        return (1 << LINEAR_BITS) + (shift - 1) * (1 << SUB_BITS) + ((value >> shift) - (1 << SUB_BITS));
+    }
+
+    static uint64_t upper_of(size_t index)
+    {
+        if (index < (1u << LINEAR_BITS))
+        {
+            return index;
+        }
+        int shift = (int)((index - (1 << LINEAR_BITS)) >> SUB_BITS) + 1;
+        uint64_t sub = ((index - (1 << LINEAR_BITS)) & ((1 << SUB_BITS) - 1)) + (1 << SUB_BITS);
+        return ((sub + 1) << shift) - 1;
+    }
+
+    std::vector<uint64_t> m_counts;
+    uint64_t m_count;
+    uint64_t m_sum;
+    uint64_t m_min;
+    uint64_t m_max;
+};
+
+#endif /* __HISTOGRAM_H__ */
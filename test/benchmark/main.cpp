@@ -0,0 +1,166 @@
+#include <stdlib.h>
+#include <string.h>
+#include "Bench.h"
+
+static void usage(const char *name)
+{
+    printf("usage: %s [options] [threadpool|blockqueue|ringbuffer ...]\n"
+           "  --format=csv|json   输出格式，默认 csv\n"
+           "  --output=FILE       输出到文件，默认标准输出\n"
+           "  --cpus=0,2,4        线程按顺序轮流绑定到这些CPU\n"
+           "  --ops=N             每个配置的操作数量，默认 200000\n"
+           "  --quick             只跑较小的配置矩阵\n", name);
+}
+
+static void write_csv(FILE *fp, const std::vector<BenchResult> &results)
+{
+    fprintf(fp, "bench,metric,config,threads,ops,seconds,ops_per_sec,mb_per_sec,"
+                "lat_min_ns,lat_mean_ns,lat_p50_ns,lat_p90_ns,lat_p99_ns,lat_p999_ns,lat_max_ns\n");
+
+    for (const BenchResult &r : results)
+    {
+        fprintf(fp, "%s,%s,%s,%d,%llu,%.6f,%.1f,%.2f,%llu,%.1f,%llu,%llu,%llu,%llu,%llu\n",
+                r.bench.c_str(), r.metric.c_str(), r.config.c_str(), r.threads,
+                (unsigned long long)r.ops, r.seconds, r.ops / r.seconds,
+                r.bytes / r.seconds / (1024 * 1024),
+                (unsigned long long)r.latency.min(), r.latency.mean(),
+                (unsigned long long)r.latency.percentile(50),
+                (unsigned long long)r.latency.percentile(90),
+                (unsigned long long)r.latency.percentile(99),
+                (unsigned long long)r.latency.percentile(99.9),
+                (unsigned long long)r.latency.max());
+    }
+}
+
+static void write_json(FILE *fp, const std::vector<BenchResult> &results)
+{
+    fprintf(fp, "[\n");
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const BenchResult &r = results[i];
+        fprintf(fp, "  {\"bench\": \"%s\", \"metric\": \"%s\", \"config\": \"%s\", \"threads\": %d, "
+                    "\"ops\": %llu, \"seconds\": %.6f, \"ops_per_sec\": %.1f, \"mb_per_sec\": %.2f, "
+                    "\"latency_ns\": {\"min\": %llu, \"mean\": %.1f, \"p50\": %llu, \"p90\": %llu, "
+                    "\"p99\": %llu, \"p999\": %llu, \"max\": %llu}}%s\n",
+                r.bench.c_str(), r.metric.c_str(), r.config.c_str(), r.threads,
+                (unsigned long long)r.ops, r.seconds, r.ops / r.seconds,
+                r.bytes / r.seconds / (1024 * 1024),
+                (unsigned long long)r.latency.min(), r.latency.mean(),
+                (unsigned long long)r.latency.percentile(50),
+                (unsigned long long)r.latency.percentile(90),
+                (unsigned long long)r.latency.percentile(99),
+                (unsigned long long)r.latency.percentile(99.9),
+                (unsigned long long)r.latency.max(),
+                i + 1 < results.size() ? "," : "");
+    }
+    fprintf(fp, "]\n");
+}
+
+int main(int argc, char *argv[])
+{
+    BenchOptions opt;
+    bool json = false;
+    const char *output = NULL;
+    std::vector<std::string> benches;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *arg = argv[i];
+
+        if (strcmp(arg, "--format=json") == 0)
+        {
+            json = true;
+        }
+        else if (strcmp(arg, "--format=csv") == 0)
+        {
+            json = false;
+        }
+        else if (strncmp(arg, "--output=", 9) == 0)
+        {
+            output = arg + 9;
+        }
+        else if (strncmp(arg, "--cpus=", 7) == 0)
+        {
+            for (const char *p = arg + 7; *p; )
+            {
+                opt.cpus.push_back(atoi(p));
+                p = strchr(p, ',');
+                if (!p) break;
+                ++p;
+            }
+        }
+        else if (strncmp(arg, "--ops=", 6) == 0)
+        {
+            opt.ops = strtoull(arg + 6, NULL, 10);
+        }
+        else if (strcmp(arg, "--quick") == 0)
+        {
+            opt.quick = true;
+        }
+        else if (arg[0] != '-')
+        {
+            benches.push_back(arg);
+        }
+        else
+        {
+            usage(argv[0]);
+            return -1;
+        }
+    }
+
+    if (opt.ops == 0)
+    {
+        usage(argv[0]);
+        return -1;
+    }
+
+    if (benches.empty())
+    {
+        benches = {"threadpool", "blockqueue", "ringbuffer"};
+    }
+
+    std::vector<BenchResult> results;
+    for (const std::string &name : benches)
+    {
+        if (name == "threadpool")
+        {
+            bench_threadpool(opt, results);
+        }
+        else if (name == "blockqueue")
+        {
+            bench_blockqueue(opt, results);
+        }
+        else if (name == "ringbuffer")
+        {
+            bench_ringbuffer(opt, results);
+        }
+        else
+        {
+            usage(argv[0]);
+            return -1;
+        }
+    }
+
+    FILE *fp = output ? fopen(output, "w") : stdout;
+    if (!fp)
+    {
+        printf("open %s fail\n", output);
+        return -1;
+    }
+
+    if (json)
+    {
+        write_json(fp, results);
+    }
+    else
+    {
+        write_csv(fp, results);
+    }
+
+    if (fp != stdout)
+    {
+        fclose(fp);
+    }
+
+    return 0;
+}
@@ -0,0 +1,395 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <thread>
+#include <vector>
+#include "RingBufferMpmc.h"
+#include "list.h"
+#include "epoch.h"
+
+/**
+/*@brief 无锁结构压力测试
+/*
+/* ringbuffer_mpmc(MPSC/MPMC)、mpsc 队列、Treiber 栈：多个生产者写入带 (生产者, 序号) 的记录，
+/* 检查不丢失、不重复，同一生产者的记录在每个消费者看来保持顺序。
+/* RCU 链表 + epoch 回收：读者遍历时写者不断替换节点，检查读者不会看到已回收的节点。
+*/
+
+#define TEST_PRODUCERS  4
+#define TEST_RECORDS    200000      //每个生产者写入的记录数
+
+static int errors = 0;
+
+#define CHECK(cond)                                                         \
+    do                                                                      \
+    {                                                                       \
+        if (!(cond))                                                        \
+        {                                                                   \
+            if (__atomic_add_fetch(&errors, 1, __ATOMIC_RELAXED) <= 10)     \
+            {                                                               \
+                printf("%s:%d check fail: %s\n", __FILE__, __LINE__, #cond); \
+            }                                                               \
+        }                                                                   \
+    } while (0)
+
+typedef struct test_record_t
+{
+    uint32_t producer;
+    uint32_t pad;
+    uint64_t seq;
+} test_record_t;
+
+#define TEST_RING_RECORD    256     //ringbuffer_mpmc 中一条记录的大小，拷贝时间越长越容易暴露发布顺序的问题
+
+typedef struct test_ring_record_t
+{
+    test_record_t record;
+    uint8_t payload[TEST_RING_RECORD - sizeof(test_record_t)];
+} test_ring_record_t;
+
+static void fill_payload(test_ring_record_t *record)
+{
+    for (size_t i = 0; i < sizeof(record->payload); ++i)
+    {
+        record->payload[i] = (uint8_t)(record->record.producer * 131 + record->record.seq * 7 + i);
+    }
+}
+
+static bool check_payload(const test_ring_record_t *record)
+{
+    for (size_t i = 0; i < sizeof(record->payload); ++i)
+    {
+        if (record->payload[i] != (uint8_t)(record->record.producer * 131 + record->record.seq * 7 + i))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+/*@brief 记录每条记录被取到的次数，结束后每条必须恰好一次
+/*
+*/
+class SeenTable
+{
+public:
+    SeenTable() : seen_(TEST_PRODUCERS * TEST_RECORDS, 0) {}
+
+    void mark(uint32_t producer, uint64_t seq)
+    {
+        CHECK(producer < TEST_PRODUCERS && seq < TEST_RECORDS);
+        if (producer < TEST_PRODUCERS && seq < TEST_RECORDS)
+        {
+            CHECK(__atomic_exchange_n(&seen_[producer * TEST_RECORDS + seq], 1, __ATOMIC_RELAXED) == 0);
+        }
+    }
+
+    bool complete(void)
+    {
+        for (uint8_t v : seen_)
+        {
+            if (v != 1)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    std::vector<uint8_t> seen_;
+};
+
+static void test_ringbuffer_mpmc(int consumers)
+{
+    ringbuffer_mpmc *rb = ringbuffer_mpmc_create(16 * TEST_RING_RECORD, consumers > 1);
+    SeenTable table;
+    uint64_t consumed = 0;
+    const uint64_t total = (uint64_t)TEST_PRODUCERS * TEST_RECORDS;
+    std::vector<std::thread> threads;
+
+    for (uint32_t p = 0; p < TEST_PRODUCERS; ++p)
+    {
+        threads.push_back(std::thread([=]() {
+            for (uint64_t seq = 0; seq < TEST_RECORDS; ++seq)
+            {
+                test_ring_record_t record;
+                record.record.producer = p;
+                record.record.pad = 0;
+                record.record.seq = seq;
+                fill_payload(&record);
+                while (ringbuffer_mpmc_put(rb, (const uint8_t *)&record, sizeof(record)) == 0)
+                {
+                    sched_yield();
+                }
+            }
+        }));
+    }
+
+    for (int c = 0; c < consumers; ++c)
+    {
+        threads.push_back(std::thread([&, consumers]() {
+            test_ring_record_t records[4];
+            uint64_t next[TEST_PRODUCERS] = {0};   //本消费者期望看到的每个生产者的最小序号
+
+            while (__atomic_load_n(&consumed, __ATOMIC_RELAXED) < total)
+            {
+                // 每次写入都是一整条记录，按记录大小的整数倍读取不会拆开记录
+                uint32_t len = ringbuffer_mpmc_get(rb, (uint8_t *)records, sizeof(records));
+                CHECK(len % sizeof(test_ring_record_t) == 0);
+                if (len == 0)
+                {
+                    sched_yield();
+                    continue;
+                }
+
+                for (uint32_t i = 0; i < len / sizeof(test_ring_record_t); ++i)
+                {
+                    test_record_t *record = &records[i].record;
+                    CHECK(check_payload(&records[i]));     //读到未写完的记录时内容对不上
+                    table.mark(record->producer, record->seq);
+                    if (record->producer < TEST_PRODUCERS)
+                    {
+                        // 单消费者必须连续，多消费者只要求递增
+                        CHECK(consumers > 1 ? record->seq >= next[record->producer] : record->seq == next[record->producer]);
+                        next[record->producer] = record->seq + 1;
+                    }
+                }
+                __atomic_add_fetch(&consumed, len / sizeof(test_ring_record_t), __ATOMIC_RELAXED);
+            }
+        }));
+    }
+
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    CHECK(consumed == total);
+    CHECK(table.complete());
+    CHECK(ringbuffer_mpmc_data_len(rb) == 0);
+    ringbuffer_mpmc_destroy(rb);
+
+    printf("ringbuffer_mpmc %dP/%dC: %llu records\n", TEST_PRODUCERS, consumers, (unsigned long long)consumed);
+}
+
+typedef struct test_node_t
+{
+    struct mpsc_node mpsc;
+    struct stack_node stack;
+    test_record_t record;
+    int owned;
+} test_node_t;
+
+static void test_mpsc_queue(void)
+{
+    struct mpsc_head queue;
+    std::vector<test_node_t> nodes((size_t)TEST_PRODUCERS * TEST_RECORDS);
+    SeenTable table;
+    std::vector<std::thread> threads;
+
+    init_mpsc_head(&queue);
+
+    for (uint32_t p = 0; p < TEST_PRODUCERS; ++p)
+    {
+        threads.push_back(std::thread([&, p]() {
+            for (uint64_t seq = 0; seq < TEST_RECORDS; ++seq)
+            {
+                test_node_t *node = &nodes[p * TEST_RECORDS + seq];
+                node->record.producer = p;
+                node->record.seq = seq;
+                mpsc_push(&queue, &node->mpsc);
+            }
+        }));
+    }
+
+    uint64_t next[TEST_PRODUCERS] = {0};
+    uint64_t count = 0;
+    while (count < nodes.size())
+    {
+        struct mpsc_node *ptr = mpsc_pop(&queue);
+        if (ptr == NULL)
+        {
+            sched_yield();
+            continue;
+        }
+
+        test_node_t *node = list_entry(ptr, test_node_t, mpsc);
+        table.mark(node->record.producer, node->record.seq);
+        CHECK(node->record.seq == next[node->record.producer]);
+        next[node->record.producer] = node->record.seq + 1;
+        ++count;
+    }
+
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    CHECK(mpsc_pop(&queue) == NULL);
+    CHECK(mpsc_empty(&queue));
+    CHECK(table.complete());
+
+    printf("mpsc queue %dP/1C: %llu nodes\n", TEST_PRODUCERS, (unsigned long long)count);
+}
+
+static void test_stack(void)
+{
+    const int node_count = 64;
+    const int threads_num = 8;
+    struct stack_head stack;
+    std::vector<test_node_t> nodes(node_count);
+    std::vector<std::thread> threads;
+
+    init_stack_head(&stack);
+    for (test_node_t &node : nodes)
+    {
+        node.owned = 0;
+        stack_push(&stack, &node.stack);
+    }
+
+    // 各线程反复弹出再压回，同一节点同一时刻只能被一个线程持有
+    for (int t = 0; t < threads_num; ++t)
+    {
+        threads.push_back(std::thread([&]() {
+            for (int i = 0; i < TEST_RECORDS; ++i)
+            {
+                struct stack_node *ptr = stack_pop(&stack);
+                if (ptr == NULL)
+                {
+                    continue;
+                }
+                test_node_t *node = list_entry(ptr, test_node_t, stack);
+                CHECK(__atomic_exchange_n(&node->owned, 1, __ATOMIC_ACQ_REL) == 0);
+                __atomic_store_n(&node->owned, 0, __ATOMIC_RELEASE);
+                stack_push(&stack, &node->stack);
+            }
+        }));
+    }
+
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    int count = 0;
+    while (stack_pop(&stack) != NULL)
+    {
+        ++count;
+    }
+    CHECK(count == node_count);
+    CHECK(stack_empty(&stack));
+
+    printf("treiber stack %d threads: %d nodes returned\n", threads_num, count);
+}
+
+#define RCU_LIVE    0x4c495645u
+#define RCU_DEAD    0xdeaddeadu
+
+typedef struct rcu_node_t
+{
+    struct list_head list;
+    struct epoch_head reclaim;
+    uint32_t magic;
+    uint32_t key;
+} rcu_node_t;
+
+static uint64_t rcu_freed = 0;
+
+static void rcu_node_free(struct epoch_head *head)
+{
+    rcu_node_t *node = list_entry(head, rcu_node_t, reclaim);
+    node->magic = RCU_DEAD;
+    __atomic_add_fetch(&rcu_freed, 1, __ATOMIC_RELAXED);
+    free(node);
+}
+
+static void test_rcu_epoch(void)
+{
+    const uint32_t key_count = 32;
+    const int readers_num = 4;
+    const int replaces = TEST_RECORDS;
+    struct epoch_domain domain;
+    struct list_head head;
+    std::vector<rcu_node_t *> current(key_count);
+    std::vector<std::thread> threads;
+    int stop = 0;
+
+    epoch_domain_init(&domain);
+    init_list_head(&head);
+    for (uint32_t key = 0; key < key_count; ++key)
+    {
+        rcu_node_t *node = (rcu_node_t *)malloc(sizeof(rcu_node_t));
+        node->magic = RCU_LIVE;
+        node->key = key;
+        list_add_tail_rcu(&node->list, &head);
+        current[key] = node;
+    }
+
+    for (int r = 0; r < readers_num; ++r)
+    {
+        threads.push_back(std::thread([&]() {
+            struct epoch_thread thread;
+            epoch_thread_register(&domain, &thread);
+            while (!__atomic_load_n(&stop, __ATOMIC_ACQUIRE))
+            {
+                rcu_node_t *node;
+                uint32_t key = 0;
+
+                epoch_read_lock(&thread);
+                list_for_each_entry_rcu(node, &head, list)
+                {
+                    CHECK(node->magic == RCU_LIVE);
+                    CHECK(node->key == key);     //替换不改变顺序，读者总能看到完整的一轮
+                    ++key;
+                }
+                epoch_read_unlock(&thread);
+                CHECK(key == key_count);
+            }
+            epoch_thread_unregister(&thread);
+        }));
+    }
+
+    // 单写者：原地替换节点，旧节点交给 epoch 回收
+    for (int i = 0; i < replaces; ++i)
+    {
+        uint32_t key = (uint32_t)i % key_count;
+        rcu_node_t *node = (rcu_node_t *)malloc(sizeof(rcu_node_t));
+        node->magic = RCU_LIVE;
+        node->key = key;
+        list_replace_rcu(&current[key]->list, &node->list);
+        epoch_call(&domain, &current[key]->reclaim, rcu_node_free);
+        current[key] = node;
+    }
+
+    __atomic_store_n(&stop, 1, __ATOMIC_RELEASE);
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    epoch_synchronize(&domain);
+    CHECK(rcu_freed == (uint64_t)replaces);
+
+    for (uint32_t key = 0; key < key_count; ++key)
+    {
+        free(current[key]);
+    }
+    epoch_domain_destroy(&domain);
+
+    printf("rcu list + epoch %d readers: %llu nodes reclaimed\n", readers_num, (unsigned long long)rcu_freed);
+}
+
+int main(void)
+{
+    test_ringbuffer_mpmc(1);
+    test_ringbuffer_mpmc(4);
+    test_mpsc_queue();
+    test_stack();
+    test_rcu_epoch();
+
+    printf("%s\n", errors == 0 ? "Finish Test Lockfree..." : "Test Lockfree FAIL");
+    return errors == 0 ? 0 : -1;
+}
@@ -0,0 +1,65 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include "logger.h"
+
+#define THREAD_NUM  4
+#define LOG_COUNT   100000
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+void *log_thread(void *args)
+{
+    long id = (long)args;
+    double start = now_ns();
+
+    for (int i = 0; i < LOG_COUNT; ++i)
+    {
+        LOG_INFO("thread %ld seq %d value %.3f name %s", id, i, i * 0.5, "worker");
+    }
+
+    double cost = (now_ns() - start) / LOG_COUNT;
+    LOG_WARN("thread %ld done, %.1f ns per log", id, cost);
+    printf("thread %ld: %.1f ns per log\n", id, cost);
+
+    return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *path = argc > 1 ? argv[1] : "test_logger.log";
+
+    if (logger_init(path, 0, LOGGER_POLICY_DROP) != 0)
+    {
+        printf("logger_init fail\n");
+        return -1;
+    }
+    logger_install_crash_handler();
+
+    LOG_INFO("logger test start, %d threads x %d logs", THREAD_NUM, LOG_COUNT);
+    LOG_DEBUG("debug log is filtered by default level %d", LOG_LEVEL_INFO);
+
+    pthread_t threads[THREAD_NUM];
+    for (long i = 0; i < THREAD_NUM; ++i)
+    {
+        pthread_create(&threads[i], NULL, log_thread, (void *)i);
+    }
+    for (int i = 0; i < THREAD_NUM; ++i)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    LOG_ERROR("logger test end, dropped %llu", (unsigned long long)logger_dropped());
+    logger_flush();
+    printf("dropped %llu, log written to %s\n", (unsigned long long)logger_dropped(), path);
+
+    logger_shutdown();
+    return 0;
+}
@@ -0,0 +1,235 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <thread>
+#include <vector>
+#include "reactor.h"
+
+/**
+/*@brief 回环测试：长度前缀的回显协议
+/*
+/* 每条消息为 4 字节长度 + 内容，服务器在线程池中解码并原样回复。
+/* 每个客户端线程持有若干连接，每轮在每个连接上一次写入 depth 条消息，再读回全部回复并校验。
+*/
+
+#define MSG_PAYLOAD 16      //"ccc-cc-nnnnn" 加结尾的 NUL
+
+static volatile uint64_t server_msgs = 0;
+static volatile int opened = 0;
+static volatile int closed = 0;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/**
+/*@brief 从 ringbuffer 开头拷贝数据但不移动读位置
+/*
+*/
+static void peek_copy(ringbuffer *in, uint8_t *dst, uint32_t length)
+{
+    struct iovec iov[2];
+    int count = ringbuffer_peek_regions(in, iov);
+
+    for (int i = 0; i < count && length > 0; ++i)
+    {
+        uint32_t n = MIN(length, (uint32_t)iov[i].iov_len);
+        memcpy(dst, iov[i].iov_base, n);
+        dst += n;
+        length -= n;
+    }
+}
+
+static void on_open(reactor_conn_t *conn, void *user)
+{
+    __atomic_add_fetch(&opened, 1, __ATOMIC_RELAXED);
+}
+
+static void on_close(reactor_conn_t *conn, void *user)
+{
+    __atomic_add_fetch(&closed, 1, __ATOMIC_RELAXED);
+}
+
+static void on_data(reactor_conn_t *conn, ringbuffer *in, void *user)
+{
+    uint8_t msg[4 + 1024];
+    uint64_t count = 0;
+
+    while (ringbuffer_data_len(in) >= 4)
+    {
+        uint32_t length;
+        peek_copy(in, (uint8_t *)&length, 4);
+        if (length > 1024)
+        {
+            reactor_conn_close(conn);       //非法长度，关闭连接
+            break;
+        }
+        if (ringbuffer_data_len(in) < 4 + length)
+        {
+            break;                          //消息不完整，等待更多数据
+        }
+
+        peek_copy(in, msg, 4 + length);
+        if (reactor_send(conn, msg, 4 + length) < 0)
+        {
+            break;                          //发送缓存区满，保留消息等下次
+        }
+        ringbuffer_consume(in, 4 + length);
+        ++count;
+    }
+
+    __atomic_add_fetch(&server_msgs, count, __ATOMIC_RELAXED);
+}
+
+static bool read_full(int fd, uint8_t *buf, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t ret = read(fd, buf, length);
+        if (ret <= 0)
+        {
+            return false;
+        }
+        buf += ret;
+        length -= ret;
+    }
+    return true;
+}
+
+/**
+/*@brief 客户端线程
+/*
+*/
+static void client(uint16_t port, int conns, int depth, int rounds, int id, volatile int *errors)
+{
+    const size_t msg_size = 4 + MSG_PAYLOAD;
+    std::vector<int> fds;
+    std::vector<std::vector<uint8_t>> send_bufs;    //每个连接一份，读回后逐字节比较
+    std::vector<uint8_t> recv_buf(msg_size * depth);
+
+    for (int i = 0; i < conns; ++i)
+    {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+        {
+            printf("connect fail\n");
+            __atomic_add_fetch(errors, 1, __ATOMIC_RELAXED);
+            close(fd);
+            continue;
+        }
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        fds.push_back(fd);
+        send_bufs.push_back(std::vector<uint8_t>(msg_size * depth));
+    }
+
+    for (int round = 0; round < rounds; ++round)
+    {
+        for (size_t c = 0; c < fds.size(); ++c)
+        {
+            std::vector<uint8_t> &send_buf = send_bufs[c];
+            for (int i = 0; i < depth; ++i)
+            {
+                uint8_t *msg = &send_buf[i * msg_size];
+                uint32_t length = MSG_PAYLOAD;
+                memcpy(msg, &length, 4);
+                snprintf((char *)msg + 4, MSG_PAYLOAD, "%03d-%02d-%05d", id, (int)c, (round * depth + i) % 100000);
+            }
+            if (write(fds[c], send_buf.data(), send_buf.size()) != (ssize_t)send_buf.size())
+            {
+                __atomic_add_fetch(errors, 1, __ATOMIC_RELAXED);
+            }
+        }
+
+        for (size_t c = 0; c < fds.size(); ++c)
+        {
+            if (!read_full(fds[c], recv_buf.data(), recv_buf.size()))
+            {
+                __atomic_add_fetch(errors, 1, __ATOMIC_RELAXED);
+                continue;
+            }
+            if (memcmp(recv_buf.data(), send_bufs[c].data(), recv_buf.size()) != 0)
+            {
+                __atomic_add_fetch(errors, 1, __ATOMIC_RELAXED);
+            }
+        }
+    }
+
+    for (int fd : fds)
+    {
+        close(fd);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int loops = argc > 1 ? atoi(argv[1]) : 0;
+    int clients = argc > 2 ? atoi(argv[2]) : 2;
+    int conns = argc > 3 ? atoi(argv[3]) : 8;
+    int depth = argc > 4 ? atoi(argv[4]) : 64;
+    int rounds = argc > 5 ? atoi(argv[5]) : 1000;
+
+    threadpool_t *pool = create_threadpool(4, 1024);
+
+    reactor_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.host = "127.0.0.1";
+    config.loop_num = loops;
+    config.pin_cpu = 1;
+    config.pool = pool;
+    config.handler.on_open = on_open;
+    config.handler.on_data = on_data;
+    config.handler.on_close = on_close;
+
+    reactor_t *reactor = reactor_create(&config);
+    if (!reactor)
+    {
+        return -1;
+    }
+    printf("listen on 127.0.0.1:%u\n", reactor_port(reactor));
+
+    volatile int errors = 0;
+    std::vector<std::thread> threads;
+    uint64_t start = now_ns();
+    for (int i = 0; i < clients; ++i)
+    {
+        threads.push_back(std::thread(client, reactor_port(reactor), conns, depth, rounds, i, &errors));
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    uint64_t use = now_ns() - start;
+
+    uint64_t total = (uint64_t)clients * conns * depth * rounds;
+    printf("%llu messages in %.3fs, %.0f msg/s\n", (unsigned long long)total, use / 1e9, total / (use / 1e9));
+
+    // 等待服务器处理完客户端关闭
+    for (int i = 0; i < 1000 && closed < clients * conns; ++i)
+    {
+        usleep(1000);
+    }
+    reactor_destroy(reactor);
+    destroy_threadpool(pool);
+
+    printf("server messages=%llu opened=%d closed=%d errors=%d\n",
+           (unsigned long long)server_msgs, opened, closed, errors);
+
+    bool ok = errors == 0 && server_msgs == total && opened == clients * conns && closed == opened;
+    printf("%s\n", ok ? "Finish Test Reactor..." : "Test Reactor FAIL");
+    return ok ? 0 : -1;
+}
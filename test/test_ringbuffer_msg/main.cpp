@@ -0,0 +1,132 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <deque>
+#include <vector>
+#include "RingBufferMsg.h"
+
+/**
+/*@brief 消息接口测试
+/*
+/* 1. 写位置靠近末尾时缓存区读空，再写一条需要回绕的大消息
+/* 2. 消息长度上限 RINGBUFFER_MSG_SIZE(length) <= buffer_size
+/* 3. 随机长度反复读写，和 std::deque 对照检查内容和顺序
+*/
+
+static int errors = 0;
+
+#define CHECK(cond)                                                 \
+    do                                                              \
+    {                                                               \
+        if (!(cond))                                                \
+        {                                                           \
+            printf("%s:%d check fail: %s\n", __FILE__, __LINE__, #cond); \
+            ++errors;                                               \
+        }                                                           \
+    } while (0)
+
+static void fill(std::vector<uint8_t> &msg, uint32_t seq)
+{
+    for (size_t i = 0; i < msg.size(); ++i)
+    {
+        msg[i] = (uint8_t)(seq * 31 + i);
+    }
+}
+
+static void test_large_after_wrap(void)
+{
+    ringbuffer *rb = ringbuffer_create(1024);
+    std::vector<uint8_t> msg(504), out(1024);
+
+    fill(msg, 1);
+    CHECK(ringbuffer_put_msg(rb, msg.data(), msg.size()) == msg.size());
+    CHECK(ringbuffer_get_msg(rb, out.data(), out.size()) == (int)msg.size());
+    CHECK(ringbuffer_data_len(rb) == 0);
+
+    // 写位置在 512，剩余 512 字节放不下 600 字节的记录，读空后应当从头写入
+    msg.resize(592);
+    fill(msg, 2);
+    CHECK(ringbuffer_put_msg(rb, msg.data(), msg.size()) == msg.size());
+    CHECK(ringbuffer_get_msg(rb, out.data(), out.size()) == (int)msg.size());
+    CHECK(memcmp(out.data(), msg.data(), msg.size()) == 0);
+
+    ringbuffer_destroy(rb);
+}
+
+static void test_size_limit(void)
+{
+    ringbuffer *rb = ringbuffer_create(1024);
+    uint32_t max = rb->buffer_size - sizeof(ringbuffer_msg_hdr);
+    std::vector<uint8_t> msg(rb->buffer_size), out(rb->buffer_size);
+
+    fill(msg, 3);
+    CHECK(ringbuffer_put_msg(rb, msg.data(), 0) == 0);
+    CHECK(ringbuffer_put_msg(rb, msg.data(), max + 1) == 0);
+    CHECK(ringbuffer_put_msg(rb, msg.data(), rb->buffer_size) == 0);
+    CHECK(ringbuffer_put_msg(rb, msg.data(), max) == max);
+    CHECK(ringbuffer_get_msg(rb, out.data(), out.size()) == (int)max);
+    CHECK(memcmp(out.data(), msg.data(), max) == 0);
+
+    ringbuffer_destroy(rb);
+}
+
+static void test_random(ringbuffer *rb, const char *name)
+{
+    std::deque<std::vector<uint8_t>> expect;
+    std::vector<uint8_t> out(rb->buffer_size);
+    uint32_t seq = 0;
+    uint32_t max = rb->buffer_size - sizeof(ringbuffer_msg_hdr);
+
+    srand(1);
+    for (int i = 0; i < 200000; ++i)
+    {
+        if (rand() % 2)
+        {
+            std::vector<uint8_t> msg(1 + rand() % (rand() % 8 == 0 ? max : 64));
+            fill(msg, seq);
+            if (ringbuffer_put_msg(rb, msg.data(), msg.size()) == msg.size())
+            {
+                expect.push_back(msg);
+                ++seq;
+            }
+            else
+            {
+                CHECK(!expect.empty());     //缓存区为空时任何不超过上限的消息都必须写得进去
+            }
+        }
+        else
+        {
+            int n = ringbuffer_get_msg(rb, out.data(), out.size());
+            if (expect.empty())
+            {
+                CHECK(n == 0);
+                continue;
+            }
+            CHECK(n == (int)expect.front().size());
+            CHECK(n > 0 && memcmp(out.data(), expect.front().data(), n) == 0);
+            expect.pop_front();
+        }
+    }
+
+    printf("%s: %u messages\n", name, seq);
+}
+
+int main(void)
+{
+    test_large_after_wrap();
+    test_size_limit();
+
+    ringbuffer *rb = ringbuffer_create(4096);
+    test_random(rb, "normal");
+    ringbuffer_destroy(rb);
+
+    rb = ringbuffer_create_mirrored(4096);
+    if (rb)
+    {
+        test_random(rb, "mirrored");
+        ringbuffer_destroy(rb);
+    }
+
+    printf("%s\n", errors == 0 ? "Finish Test RingBuffer Msg..." : "Test RingBuffer Msg FAIL");
+    return errors == 0 ? 0 : -1;
+}
@@ -0,0 +1,75 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <thread>
+#include "threadpool.h"
+#include "BlockQueue.h"
+#include "trace.h"
+
+/**
+/*@brief 两级流水线：生产者 -> BlockQueue -> 转发线程 -> 线程池
+/*
+/* 转发线程处理每个元素时记录 TRACE_START/TRACE_FINISH，线程池任务由线程池自己记录。
+/* 运行结束后生成 trace.json，用 chrome://tracing 或 ui.perfetto.dev 打开。
+*/
+
+static volatile int done_count = 0;
+
+static void work(void *args)
+{
+    volatile uint64_t sum = 0;
+    for (long i = 0; i < (long)(intptr_t)args; ++i)   //模拟耗时不同的任务
+    {
+        sum += i;
+    }
+    __atomic_add_fetch(&done_count, 1, __ATOMIC_RELAXED);
+}
+
+int main(int argc, char **argv)
+{
+    const int total = 2000;
+    const char *path = argc > 1 ? argv[1] : "trace.json";
+
+    trace_start();
+    TRACE_THREAD_NAME("producer");
+
+    threadpool_t *pool = create_threadpool(4, 256);
+    BlockQueue<int> queue(64);
+
+    std::thread forward([&]() {
+        TRACE_THREAD_NAME("forward");
+        int item;
+        while (queue.pop(item))
+        {
+            TRACE_EVENT(TRACE_START, "forward", &queue, item, 0);
+            while (add_task_threadpool(pool, work, (void *)(intptr_t)(1000 + item % 7 * 20000), 0) == -3)
+            {
+                usleep(10);
+            }
+            TRACE_EVENT(TRACE_FINISH, "forward", &queue, item, 0);
+        }
+    });
+
+    for (int i = 0; i < total; ++i)
+    {
+        queue.push(i);
+        if (i % 100 == 0)
+        {
+            usleep(1000);       //制造突发，观察队列深度变化
+        }
+    }
+
+    while (done_count < total)
+    {
+        usleep(1000);
+    }
+    queue.close();
+    forward.join();
+    destroy_threadpool(pool);
+    trace_stop();
+
+    int count = trace_dump_chrome(path);
+    printf("write %d trace events to %s\n", count, path);
+
+    return count >= 0 ? 0 : -1;
+}
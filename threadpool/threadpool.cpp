@@ -1,4 +1,5 @@
 #include "threadpool.h"
+#include "trace.h"
 
 /**
 /*@brief 线程池任务处理线程
@@ -13,6 +14,8 @@ static void* process_task_thread(void *args)
     struct list_head *pos = NULL;
     task_t *task = NULL;
 
+    TRACE_THREAD_NAME("threadpool");
+
     while (true)
     {
         pthread_mutex_lock(&pool->mutex);
@@ -28,11 +31,14 @@ static void* process_task_thread(void *args)
         pos = pool->tlist.next_ptr;   //从任务链表取出头结点
         --pool->cur_task_num;
         list_delete_entry(pos);       //从链表中删除
+        TRACE_EVENT(TRACE_DEQUEUE, "threadpool", pool, pos, pool->cur_task_num);
         pthread_mutex_unlock(&pool->mutex);
 
         task = list_entry(pos, task_t, node);   //从链表节点取出任务节点
+        TRACE_EVENT(TRACE_START, "threadpool task", pool, pos, 0);
         task->func(task->args);
-        free(task);
+        TRACE_EVENT(TRACE_FINISH, "threadpool task", pool, pos, 0);
+        pool->task_pool->free(task);
     }
 
     return NULL;
@@ -68,6 +74,8 @@ threadpool_t *create_threadpool(int thread_nums, int max_task_nums)
         return NULL;
     }
 
+    pool->task_pool = new ObjectPool(sizeof(task_t));
+
     pthread_mutex_init(&pool->mutex, NULL);
     pthread_cond_init(&pool->cond, NULL);
 
@@ -101,6 +109,7 @@ int destroy_threadpool(threadpool_t *pool)
     pthread_mutex_destroy(&pool->mutex);
     pthread_cond_destroy(&pool->cond);
     
+    delete pool->task_pool;
     free(pool->thread_ids);
     free(pool);
     pool = NULL;
@@ -114,7 +123,8 @@ int add_task_threadpool(threadpool_t *pool, task_func_t func, void *args, int pr
     if (!func) return -2;
     if (pool->cur_task_num > pool->max_task_num) return -3;
 
-    task_t *task = (task_t *)malloc(sizeof(task_t));
+    task_t *task = (task_t *)pool->task_pool->alloc();
+    if (!task) return -4;
     task->func = func;
     task->args = args;
 
@@ -129,6 +139,7 @@ int add_task_threadpool(threadpool_t *pool, task_func_t func, void *args, int pr
     }
 
     ++pool->cur_task_num;
+    TRACE_EVENT(TRACE_ENQUEUE, "threadpool", pool, &task->node, pool->cur_task_num);
     pthread_mutex_unlock(&pool->mutex);
 
     pthread_cond_signal(&pool->cond);   //通知线程取任务
@@ -9,6 +9,7 @@
 #include <sys/sysinfo.h>
 #include <limits.h>
 #include "list.h"
+#include "MemoryPool.h"
 
 
 /**
@@ -43,6 +44,7 @@ typedef struct threadpool_t
     pthread_mutex_t       mutex;         //互斥锁
     pthread_cond_t        cond;          //条件变量
     pthread_t             *thread_ids;   //线程池数组       
+    ObjectPool            *task_pool;    //任务节点对象池
 } threadpool_t;
 
 
@@ -7,8 +7,19 @@
 #include <vector>
 #include <assert.h>
 #include <chrono>
-
-template <typename T>
+#include <deque>
+#include <memory>
+#include "trace.h"
+
+/**
+/*@brief 阻塞队列
+/*
+/*@tparam T 元素类型
+/*@tparam Alloc 底层 std::deque 使用的分配器，可使用 MemoryPool.h 中的 PoolAllocator
+/*
+/* 定义 ENABLE_TRACE 后入队、出队记录 trace 事件，编号按入队顺序递增，出队时按 FIFO 顺序配对
+*/
+template <typename T, typename Alloc = std::allocator<T>>
 class BlockQueue
 {
 public:
@@ -65,86 +76,110 @@ public:
 
     bool full();
 private:
-    std::queue<T> m_queue;
+    typedef std::queue<T, std::deque<T, Alloc>> queue_type;
+
+    queue_type m_queue;
     std::mutex m_mutex;
     bool m_isClose;
     size_t m_capacity;
     std::condition_variable m_consumer;
     std::condition_variable m_producer;
+#ifdef ENABLE_TRACE
+    uint64_t m_traceIn;     //已入队元素数量，作为入队事件编号
+    uint64_t m_traceOut;    //已出队或丢弃的元素数量，作为出队事件编号
+#endif
 };
 
 #endif /* __BLOCKQUEUE_H__ */
 
-template <typename T>
-inline BlockQueue<T>::BlockQueue(size_t maxCapacity)
+template <typename T, typename Alloc>
+inline BlockQueue<T, Alloc>::BlockQueue(size_t maxCapacity)
 {
     assert(maxCapacity > 0);
     m_capacity = maxCapacity;
     m_isClose = false;
+#ifdef ENABLE_TRACE
+    m_traceIn = 0;
+    m_traceOut = 0;
+#endif
 }
 
-template <typename T>
-inline BlockQueue<T>::~BlockQueue()
+template <typename T, typename Alloc>
+inline BlockQueue<T, Alloc>::~BlockQueue()
 {
     close();
 }
 
-template <typename T>
-inline void BlockQueue<T>::push(T &item)
+template <typename T, typename Alloc>
+inline void BlockQueue<T, Alloc>::push(T &item)
 {
     std::unique_lock<std::mutex> lock(m_mutex);
-    m_producer.wait(lock, [this]() { return !full(); });
+    m_producer.wait(lock, [this]() { return m_isClose || m_queue.size() < m_capacity; });   //已持有锁，不能调用 full()
+    if (m_isClose) {
+        return;
+    }
 
     m_queue.push(item);
+    TRACE_EVENT(TRACE_ENQUEUE, "BlockQueue", this, m_traceIn++, m_queue.size());
     m_consumer.notify_one();
 }
 
-template <typename T>
-inline void BlockQueue<T>::push_batch(std::vector<T> &items)
+template <typename T, typename Alloc>
+inline void BlockQueue<T, Alloc>::push_batch(std::vector<T> &items)
 {
     std::unique_lock<std::mutex> lock(m_mutex);
     m_producer.wait(lock, [this, &items]{
-        return m_queue.size() + items.size() <= m_capacity;
+        return m_isClose || m_queue.size() + items.size() <= m_capacity;
     });
+    if (m_isClose) {
+        return;
+    }
 
     for (auto &item : items)
     {
         m_queue.push(item);
+        TRACE_EVENT(TRACE_ENQUEUE, "BlockQueue", this, m_traceIn++, m_queue.size());
     }
 
     m_consumer.notify_all();
 }
 
-template <typename T>
-inline bool BlockQueue<T>::pop(T &item)
+template <typename T, typename Alloc>
+inline bool BlockQueue<T, Alloc>::pop(T &item)
 {
     std::unique_lock<std::mutex> lock(m_mutex);
-    m_consumer.wait(lock, [this]() { return m_isClose || !empty(); });
+    m_consumer.wait(lock, [this]() { return m_isClose || !m_queue.empty(); });   //已持有锁，不能调用 empty()
 
+    if (m_queue.empty()) {
+        return false; // 队列关闭且为空，无法获取元素
+    }
     item = std::move(m_queue.front());
     m_queue.pop();
+    TRACE_EVENT(TRACE_DEQUEUE, "BlockQueue", this, m_traceOut++, m_queue.size());
 
     m_producer.notify_one();
     return true;
 }
 
-template <typename T>
-inline bool BlockQueue<T>::pop(T &item, int timeout)
+template <typename T, typename Alloc>
+inline bool BlockQueue<T, Alloc>::pop(T &item, int timeout)
 {
     std::unique_lock<std::mutex> lock(m_mutex);
-    m_consumer.wait(lock, [this]() { return m_isClose || !empty(); });
+    m_consumer.wait_for(lock, std::chrono::milliseconds(timeout),
+                        [this]() { return m_isClose || !m_queue.empty(); });
 
-    if (m_isClose && empty()) {
-        return false; // 队列关闭且为空，无法获取元素
+    if (m_queue.empty()) {
+        return false; // 队列关闭或超时，无法获取元素
     }
     item = std::move(m_queue.front());
     m_queue.pop();
+    TRACE_EVENT(TRACE_DEQUEUE, "BlockQueue", this, m_traceOut++, m_queue.size());
     m_producer.notify_one();
     return true;
 }
 
-template <typename T>
-inline size_t BlockQueue<T>::pop_batch(std::vector<T> &items, size_t maxCount)
+template <typename T, typename Alloc>
+inline size_t BlockQueue<T, Alloc>::pop_batch(std::vector<T> &items, size_t maxCount)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
     size_t availableItems = std::min(maxCount, m_queue.size());
@@ -156,6 +191,7 @@ inline size_t BlockQueue<T>::pop_batch(std::vector<T> &items, size_t maxCount)
     {
         items.push_back(std::move(m_queue.front()));
         m_queue.pop();
+        TRACE_EVENT(TRACE_DEQUEUE, "BlockQueue", this, m_traceOut++, m_queue.size());
     }
 
     if (availableItems > 0)
@@ -165,12 +201,15 @@ inline size_t BlockQueue<T>::pop_batch(std::vector<T> &items, size_t maxCount)
     return availableItems;
 }
 
-template <typename T>
-inline void BlockQueue<T>::close()
+template <typename T, typename Alloc>
+inline void BlockQueue<T, Alloc>::close()
 {
     {
         std::lock_guard<std::mutex> lock(m_mutex);
-        std::queue<T> emptyQueue;
+#ifdef ENABLE_TRACE
+        m_traceOut += m_queue.size();   //丢弃的元素也占用编号，保持入队与出队配对
+#endif
+        queue_type emptyQueue;
         std::swap(m_queue, emptyQueue);
         m_isClose = true;
     }
@@ -179,26 +218,29 @@ inline void BlockQueue<T>::close()
     m_consumer.notify_all();
 
 }
-template <typename T>
-inline void BlockQueue<T>::flush()
+template <typename T, typename Alloc>
+inline void BlockQueue<T, Alloc>::flush()
 {
     m_consumer.notify_all();
 }
-template <typename T>
-inline void BlockQueue<T>::clear()
+template <typename T, typename Alloc>
+inline void BlockQueue<T, Alloc>::clear()
 {
     std::lock_guard<std::mutex> lock(m_mutex);
-    std::queue<T> emptyQueue;
+#ifdef ENABLE_TRACE
+    m_traceOut += m_queue.size();
+#endif
+    queue_type emptyQueue;
     std::swap(m_queue, emptyQueue);
 }
-template <typename T>
-inline bool BlockQueue<T>::empty()
+template <typename T, typename Alloc>
+inline bool BlockQueue<T, Alloc>::empty()
 {
     std::lock_guard<std::mutex> lock(m_mutex);
     return m_queue.empty();
 }
-template <typename T>
-inline bool BlockQueue<T>::full()
+template <typename T, typename Alloc>
+inline bool BlockQueue<T, Alloc>::full()
 {
     std::lock_guard<std::mutex> lock(m_mutex);
     return m_queue.size() >= m_capacity;
@@ -0,0 +1,616 @@
+#ifndef __MEMORYPOOL_H__
+#define __MEMORYPOOL_H__
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <cstddef>
+
+/**
+/*@brief 定长对象池
+/*
+/* 采用 magazine + depot 两级结构：每个线程槽位持有两个 magazine (loaded/previous)，
+/* 分配释放只在本槽位内完成，槽位锁几乎没有竞争；magazine 满或空时才与全局 depot 交换整个 magazine。
+/* 线程按首次使用顺序编号后映射到槽位，线程数不超过槽位数时每个线程独占一个槽位。
+/* 对象内存按块从系统申请，池销毁前不归还，对象可以在任意线程释放。
+*/
+class ObjectPool
+{
+public:
+    /**
+    /*@brief 构造对象池
+    /*
+    /*@param objectSize 对象大小
+    /*@param magazineSize 每个 magazine 缓存的对象数量
+    /*@param slotCount 线程槽位数量，0 表示按CPU数量的两倍
+    */
+    explicit ObjectPool(size_t objectSize, size_t magazineSize = 64, size_t slotCount = 0);
+    ~ObjectPool();
+
+    ObjectPool(const ObjectPool &) = delete;
+    ObjectPool &operator=(const ObjectPool &) = delete;
+
+    /**
+    /*@brief 分配一个对象
+    /*
+    /*@return void* 对象内存，内存不足返回 nullptr
+    */
+    void *alloc();
+
+    /**
+    /*@brief 释放一个对象
+    /*
+    /*@param ptr alloc 返回的指针
+    */
+    void free(void *ptr);
+
+    /**
+    /*@brief 按大小获取进程内共享的对象池
+    /*
+    /* 大小向上取整到 16 字节 (不超过256) 或 2 的幂 (不超过4096)，超过 4096 返回 nullptr。
+    /* 这些池在进程退出前不会销毁。
+    /*
+    /*@param size 对象大小
+    /*@return ObjectPool* 对象池
+    */
+    static ObjectPool *for_size(size_t size);
+
+    size_t object_size() const { return m_objectSize; }
+
+    static const size_t MAX_CLASS_SIZE = 4096;
+
+private:
+    struct Magazine
+    {
+        Magazine *next;
+        size_t count;
+        void *rounds[1];
+    };
+
+    struct alignas(64) Slot
+    {
+        std::atomic_flag lock = ATOMIC_FLAG_INIT;
+        Magazine *loaded = nullptr;
+        Magazine *previous = nullptr;
+    };
+
+    struct Chunk
+    {
+        Chunk *next;
+    };
+
+    Magazine *new_magazine();
+    Magazine *depot_get(Magazine **list);
+    void depot_put(Magazine **list, Magazine *mag);
+    bool refill(Magazine *mag);
+    Slot &local_slot();
+
+    size_t m_objectSize;
+    size_t m_magazineSize;
+    size_t m_slotMask;
+    Slot *m_slots;
+
+    std::mutex m_mutex;         //保护以下 depot 成员
+    Magazine *m_full;           //满 magazine 链表
+    Magazine *m_empty;          //空 magazine 链表
+    Chunk *m_chunks;            //从系统申请的内存块
+    Chunk *m_loose;             //没有 magazine 可放时释放的对象
+};
+
+inline ObjectPool::ObjectPool(size_t objectSize, size_t magazineSize, size_t slotCount)
+{
+    assert(objectSize > 0 && magazineSize > 0);
+
+    // 对象至少能放下一个指针，并按指针大小对齐
+    m_objectSize = (objectSize + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+    m_magazineSize = magazineSize;
+
+    if (slotCount == 0)
+    {
+        slotCount = std::thread::hardware_concurrency() * 2;
+    }
+    size_t slots = 1;
+    while (slots < slotCount)
+    {
+        slots <<= 1;
+    }
+    m_slotMask = slots - 1;
+    // C++11 的 new 不保证超过 alignof(max_align_t) 的对齐
+    void *mem = nullptr;
+    if (posix_memalign(&mem, alignof(Slot), slots * sizeof(Slot)) != 0)
+    {
+        throw std::bad_alloc();
+    }
+    m_slots = (Slot *)mem;
+    for (size_t i = 0; i < slots; ++i)
+    {
+        new (&m_slots[i]) Slot();
+    }
+
+    m_full = nullptr;
+    m_empty = nullptr;
+    m_chunks = nullptr;
+    m_loose = nullptr;
+}
+
+inline ObjectPool::~ObjectPool()
+{
+    for (size_t i = 0; i <= m_slotMask; ++i)
+    {
+        ::free(m_slots[i].loaded);
+        ::free(m_slots[i].previous);
+    }
+    ::free(m_slots);
+
+    for (Magazine *list : {m_full, m_empty})
+    {
+        while (list)
+        {
+            Magazine *next = list->next;
+            ::free(list);
+            list = next;
+        }
+    }
+
+    while (m_chunks)
+    {
+        Chunk *next = m_chunks->next;
+        ::free(m_chunks);
+        m_chunks = next;
+    }
+}
+
+inline ObjectPool::Magazine *ObjectPool::new_magazine()
+{
+    Magazine *mag = (Magazine *)malloc(sizeof(Magazine) + (m_magazineSize - 1) * sizeof(void *));
+    if (mag)
+    {
+        mag->next = nullptr;
+        mag->count = 0;
+    }
+    return mag;
+}
+
+inline ObjectPool::Magazine *ObjectPool::depot_get(Magazine **list)
+{
+    Magazine *mag = *list;
+    if (mag)
+    {
+        *list = mag->next;
+    }
+    return mag;
+}
+
+inline void ObjectPool::depot_put(Magazine **list, Magazine *mag)
+{
+    mag->next = *list;
+    *list = mag;
+}
+
+/**
+/*@brief 装满空的 mag，优先使用散对象，没有时从系统申请一块内存切成对象，调用时持有 m_mutex
+/*
+*/
+inline bool ObjectPool::refill(Magazine *mag)
+{
+    while (m_loose && mag->count < m_magazineSize)
+    {
+        mag->rounds[mag->count++] = m_loose;
+        m_loose = m_loose->next;
+    }
+    if (mag->count > 0)
+    {
+        return true;
+    }
+
+    size_t header = (sizeof(Chunk) + 63) & ~(size_t)63;
+    Chunk *chunk = (Chunk *)malloc(header + m_objectSize * m_magazineSize);
+    if (!chunk)
+    {
+        return false;
+    }
+    chunk->next = m_chunks;
+    m_chunks = chunk;
+
+    char *objects = (char *)chunk + header;
+    for (size_t i = 0; i < m_magazineSize; ++i)
+    {
+        mag->rounds[i] = objects + i * m_objectSize;
+    }
+    mag->count = m_magazineSize;
+    return true;
+}
+
+inline ObjectPool::Slot &ObjectPool::local_slot()
+{
+    static std::atomic<unsigned> nextIndex(0);
+    static thread_local unsigned index = nextIndex.fetch_add(1, std::memory_order_relaxed);
+
+    return m_slots[index & m_slotMask];
+}
+
+inline void *ObjectPool::alloc()
+{
+    Slot &slot = local_slot();
+    void *ptr = nullptr;
+
+    while (slot.lock.test_and_set(std::memory_order_acquire))
+    {
+        std::this_thread::yield();
+    }
+
+    if (!slot.loaded && !(slot.loaded = new_magazine()))
+    {
+        slot.lock.clear(std::memory_order_release);
+        return nullptr;
+    }
+
+    if (slot.loaded->count == 0 && slot.previous && slot.previous->count > 0)
+    {
+        std::swap(slot.loaded, slot.previous);
+    }
+
+    if (slot.loaded->count == 0)
+    {
+        // 两个 magazine 都空了，用 depot 中的满 magazine 换掉 previous
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Magazine *full = depot_get(&m_full);
+
+        if (full)
+        {
+            if (slot.previous)
+            {
+                depot_put(&m_empty, slot.previous);
+            }
+            slot.previous = slot.loaded;
+            slot.loaded = full;
+        }
+        else
+        {
+            refill(slot.loaded);
+        }
+    }
+
+    if (slot.loaded->count > 0)
+    {
+        ptr = slot.loaded->rounds[--slot.loaded->count];
+    }
+
+    slot.lock.clear(std::memory_order_release);
+    return ptr;
+}
+
+inline void ObjectPool::free(void *ptr)
+{
+    if (!ptr)
+    {
+        return;
+    }
+
+    Slot &slot = local_slot();
+
+    while (slot.lock.test_and_set(std::memory_order_acquire))
+    {
+        std::this_thread::yield();
+    }
+
+    if (slot.loaded && slot.loaded->count == m_magazineSize && slot.previous && slot.previous->count == 0)
+    {
+        std::swap(slot.loaded, slot.previous);
+    }
+
+    if (!slot.loaded || slot.loaded->count == m_magazineSize)
+    {
+        // 两个 magazine 都满了，把 previous 交给 depot，换一个空 magazine
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Magazine *empty = depot_get(&m_empty);
+
+        if (!empty)
+        {
+            empty = new_magazine();
+        }
+
+        if (empty)
+        {
+            if (slot.previous)
+            {
+                depot_put(&m_full, slot.previous);
+            }
+            slot.previous = slot.loaded;
+            slot.loaded = empty;
+        }
+    }
+
+    if (slot.loaded && slot.loaded->count < m_magazineSize)
+    {
+        slot.loaded->rounds[slot.loaded->count++] = ptr;
+    }
+    else
+    {
+        // 申请不到 magazine 时挂到 depot 的散对象链表上
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ((Chunk *)ptr)->next = m_loose;
+        m_loose = (Chunk *)ptr;
+    }
+
+    slot.lock.clear(std::memory_order_release);
+}
+
+inline ObjectPool *ObjectPool::for_size(size_t size)
+{
+    static const size_t SMALL_CLASSES = 16;     //16 ~ 256，步长16
+    static const size_t CLASS_COUNT = SMALL_CLASSES + 4;  //512, 1024, 2048, 4096
+    static ObjectPool *pools[CLASS_COUNT];
+    static std::once_flag once;
+
+    if (size > MAX_CLASS_SIZE)
+    {
+        return nullptr;
+    }
+
+    std::call_once(once, []() {
+        for (size_t i = 0; i < SMALL_CLASSES; ++i)
+        {
+            pools[i] = new ObjectPool((i + 1) * 16);
+        }
+        for (size_t i = 0; i < CLASS_COUNT - SMALL_CLASSES; ++i)
+        {
+            pools[SMALL_CLASSES + i] = new ObjectPool((size_t)512 << i);
+        }
+    });
+
+    if (size <= 256)
+    {
+        return pools[size == 0 ? 0 : (size + 15) / 16 - 1];
+    }
+
+    size_t index = SMALL_CLASSES;
+    for (size_t cls = 512; cls < size; cls <<= 1)
+    {
+        ++index;
+    }
+    return pools[index];
+}
+
+
+/**
+/*@brief 线性分配的内存区域
+/*
+/* 分配只移动指针，单个对象不能释放，reset 一次性回收全部内存并保留已申请的内存块供下次使用。
+/* 适合单次请求内的临时数据。不是线程安全的，每个线程使用自己的实例，或使用 Arena::local()。
+*/
+class Arena
+{
+public:
+    explicit Arena(size_t blockSize = 64 * 1024);
+    ~Arena();
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    /**
+    /*@brief 分配内存
+    /*
+    /*@param size 大小
+    /*@param align 对齐，必须为2的幂
+    /*@return void* 内存地址，内存不足返回 nullptr
+    */
+    void *alloc(size_t size, size_t align = alignof(std::max_align_t));
+
+    /**
+    /*@brief 回收全部已分配内存，保留内存块
+    /*
+    */
+    void reset();
+
+    /**
+    /*@brief 获取已分配的字节数，包括对齐填充
+    /*
+    */
+    size_t used() const { return m_used; }
+
+    /**
+    /*@brief 获取当前线程的 Arena
+    /*
+    */
+    static Arena &local();
+
+private:
+    struct Block
+    {
+        Block *next;
+        size_t size;
+    };
+
+    char *block_begin(Block *block) { return (char *)(block + 1); }
+
+    size_t m_blockSize;
+    Block *m_first;         //内存块链表
+    Block *m_current;       //当前分配的内存块
+    char *m_ptr;            //当前块的下一个空闲位置
+    char *m_end;            //当前块的末尾
+    size_t m_used;
+};
+
+inline Arena::Arena(size_t blockSize)
+{
+    m_blockSize = blockSize;
+    m_first = nullptr;
+    m_current = nullptr;
+    m_ptr = nullptr;
+    m_end = nullptr;
+    m_used = 0;
+}
+
+inline Arena::~Arena()
+{
+    while (m_first)
+    {
+        Block *next = m_first->next;
+        ::free(m_first);
+        m_first = next;
+    }
+}
+
+inline void *Arena::alloc(size_t size, size_t align)
+{
+    assert((align & (align - 1)) == 0);
+
+    char *ptr = (char *)(((uintptr_t)m_ptr + align - 1) & ~(uintptr_t)(align - 1));
+
+    while (!m_current || ptr + size > m_end)
+    {
+        Block *next = m_current ? m_current->next : m_first;
+
+        // 复用 reset 前留下的块，放不下时在当前块之后插入新块
+        if (!next || next->size < size + align)
+        {
+            size_t blockSize = size + align > m_blockSize ? size + align : m_blockSize;
+            Block *block = (Block *)malloc(sizeof(Block) + blockSize);
+            if (!block)
+            {
+                return nullptr;
+            }
+            block->size = blockSize;
+            block->next = next;
+            if (m_current)
+            {
+                m_current->next = block;
+            }
+            else
+            {
+                m_first = block;
+            }
+            next = block;
+        }
+
+        m_current = next;
+        m_ptr = block_begin(next);
+        m_end = m_ptr + next->size;
+        ptr = (char *)(((uintptr_t)m_ptr + align - 1) & ~(uintptr_t)(align - 1));
+    }
+
+    m_used += ptr + size - m_ptr;
+    m_ptr = ptr + size;
+    return ptr;
+}
+
+inline void Arena::reset()
+{
+    m_current = nullptr;
+    m_ptr = nullptr;
+    m_end = nullptr;
+    m_used = 0;
+}
+
+inline Arena &Arena::local()
+{
+    static thread_local Arena arena;
+    return arena;
+}
+
+
+/**
+/*@brief 使用共享对象池的 STL 分配器
+/*
+/* 不超过 ObjectPool::MAX_CLASS_SIZE 的分配走 ObjectPool::for_size，更大的走 operator new。
+/* 无状态，所有实例相等，可用于 std::list/std::map/std::deque 等容器。
+*/
+template <typename T>
+class PoolAllocator
+{
+public:
+    typedef T value_type;
+
+    PoolAllocator() noexcept {}
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U> &) noexcept {}
+
+    T *allocate(size_t n)
+    {
+        size_t size = n * sizeof(T);
+        ObjectPool *pool = ObjectPool::for_size(size);
+        void *ptr = pool ? pool->alloc() : ::operator new(size);
+
+        if (!ptr)
+        {
+            throw std::bad_alloc();
+        }
+        return (T *)ptr;
+    }
+
+    void deallocate(T *ptr, size_t n)
+    {
+        ObjectPool *pool = ObjectPool::for_size(n * sizeof(T));
+
+        if (pool)
+        {
+            pool->free(ptr);
+        }
+        else
+        {
+            ::operator delete(ptr);
+        }
+    }
+
+    template <typename U>
+    struct rebind { typedef PoolAllocator<U> other; };
+};
+
+template <typename T, typename U>
+inline bool operator==(const PoolAllocator<T> &, const PoolAllocator<U> &) { return true; }
+
+template <typename T, typename U>
+inline bool operator!=(const PoolAllocator<T> &, const PoolAllocator<U> &) { return false; }
+
+
+/**
+/*@brief 使用 Arena 的 STL 分配器
+/*
+/* deallocate 不回收内存，容器的内存随 Arena::reset 一起回收，容器必须先于 reset 销毁或不再使用。
+/* 默认构造使用当前线程的 Arena。
+*/
+template <typename T>
+class ArenaAllocator
+{
+public:
+    typedef T value_type;
+
+    ArenaAllocator() noexcept : m_arena(&Arena::local()) {}
+    explicit ArenaAllocator(Arena &arena) noexcept : m_arena(&arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) noexcept : m_arena(other.arena()) {}
+
+    T *allocate(size_t n)
+    {
+        void *ptr = m_arena->alloc(n * sizeof(T), alignof(T));
+
+        if (!ptr)
+        {
+            throw std::bad_alloc();
+        }
+        return (T *)ptr;
+    }
+
+    void deallocate(T *, size_t) {}
+
+    Arena *arena() const { return m_arena; }
+
+    template <typename U>
+    struct rebind { typedef ArenaAllocator<U> other; };
+
+private:
+    Arena *m_arena;
+};
+
+template <typename T, typename U>
+inline bool operator==(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) { return a.arena() == b.arena(); }
+
+template <typename T, typename U>
+inline bool operator!=(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) { return a.arena() != b.arena(); }
+
+#endif /* __MEMORYPOOL_H__ */
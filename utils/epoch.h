@@ -0,0 +1,227 @@
+#ifndef __EPOCH_H__
+#define __EPOCH_H__
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/membarrier.h>
+#include "list.h"
+
+#define EPOCH_RECLAIM_BATCH	64	// 待回收对象达到该数量时才尝试推进 epoch
+#define EPOCH_LIMBO_COUNT	3	// 当前、上一个、上上个 epoch 的待回收链
+
+/*
+ * 延迟回收节点，嵌入到需要延迟释放的结构体中，回调里用 list_entry 取回数据节点释放
+ */
+struct epoch_head {
+	struct epoch_head *next_ptr;
+	void (*func)(struct epoch_head *head);
+};
+
+/*
+ * 读者线程记录，每个读者线程注册一个，通常放在 thread_local 变量中
+ * local 的 bit0 表示是否在读临界区内，其余位为进入时看到的全局 epoch
+ */
+struct epoch_thread {
+	uint64_t local;
+	uint32_t nest;			// 读临界区嵌套深度
+	struct epoch_domain *domain;
+	struct list_head node;
+} __attribute__((aligned(64)));
+
+/*
+ * 基于 epoch 的内存回收域
+ * 读者进入临界区时记录当前全局 epoch，退出时清除；写者摘除节点后用 epoch_call 挂到当前 epoch 的待回收链。
+ * 只有所有在临界区内的读者都已看到当前 epoch 时，全局 epoch 才能加一；
+ * epoch e 挂入的对象在全局 epoch 到达 e + 2 时一定不再被任何读者引用，此时执行回调。
+ * 内核支持 membarrier 时，读者进出临界区只有普通读写和编译器屏障，
+ * 内存屏障的开销转移到推进 epoch 的写者一侧。
+ */
+struct epoch_domain {
+	uint64_t epoch __attribute__((aligned(64)));	// 全局 epoch
+	int membarrier;					// 是否使用 membarrier
+	pthread_mutex_t lock;				// 保护线程链表和待回收链
+	struct list_head threads;			// 已注册的读者线程
+	struct epoch_head *limbo[EPOCH_LIMBO_COUNT];	// 按 epoch % 3 分组的待回收链
+	size_t pending;					// 待回收对象数量
+};
+
+// 初始化回收域，成功返回0
+static inline int epoch_domain_init(struct epoch_domain *domain)
+{
+	long cmds;
+
+	memset(domain, 0, sizeof(*domain));
+	init_list_head(&domain->threads);
+	pthread_mutex_init(&domain->lock, NULL);
+
+	cmds = syscall(__NR_membarrier, MEMBARRIER_CMD_QUERY, 0);
+	if (cmds > 0 && (cmds & MEMBARRIER_CMD_PRIVATE_EXPEDITED) &&
+	    syscall(__NR_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0) == 0)
+		domain->membarrier = 1;
+
+	return 0;
+}
+
+// 执行一条待回收链上的回调
+static inline void epoch_run_callbacks(struct epoch_head *list)
+{
+	while (list) {
+		struct epoch_head *next = list->next_ptr;
+
+		list->func(list);
+		list = next;
+	}
+}
+
+// 写者一侧的全屏障，保证读者的 local 写入对写者可见
+static inline void epoch_barrier(struct epoch_domain *domain)
+{
+	if (!domain->membarrier ||
+	    syscall(__NR_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0) != 0)
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+/*
+ * 尝试推进全局 epoch，调用时持有 domain->lock
+ * 成功时返回已满两个 epoch 的待回收链，由调用者在释放锁后执行；不能推进返回 NULL
+ */
+static inline struct epoch_head *epoch_try_advance(struct epoch_domain *domain, int *advanced)
+{
+	uint64_t epoch = domain->epoch;
+	struct epoch_thread *pos;
+	struct epoch_head *list;
+
+	*advanced = 0;
+	epoch_barrier(domain);
+
+	list_for_each_entry(pos, &domain->threads, node) {
+		uint64_t local = __atomic_load_n(&pos->local, __ATOMIC_ACQUIRE);
+
+		if ((local & 1) && (local >> 1) != epoch)
+			return NULL;
+	}
+
+	__atomic_store_n(&domain->epoch, epoch + 1, __ATOMIC_RELEASE);
+	*advanced = 1;
+
+	// (epoch + 1) - 2 与 epoch + 2 同余
+	list = domain->limbo[(epoch + 2) % EPOCH_LIMBO_COUNT];
+	domain->limbo[(epoch + 2) % EPOCH_LIMBO_COUNT] = NULL;
+	for (struct epoch_head *p = list; p; p = p->next_ptr)
+		--domain->pending;
+
+	return list;
+}
+
+/*
+ * 销毁回收域，执行全部待回收回调，调用时不能有读者在临界区内
+ */
+static inline void epoch_domain_destroy(struct epoch_domain *domain)
+{
+	for (int i = 0; i < EPOCH_LIMBO_COUNT; ++i) {
+		epoch_run_callbacks(domain->limbo[i]);
+		domain->limbo[i] = NULL;
+	}
+	domain->pending = 0;
+	pthread_mutex_destroy(&domain->lock);
+}
+
+// 注册读者线程
+static inline void epoch_thread_register(struct epoch_domain *domain, struct epoch_thread *thread)
+{
+	thread->local = 0;
+	thread->nest = 0;
+	thread->domain = domain;
+
+	pthread_mutex_lock(&domain->lock);
+	list_add_tail(&thread->node, &domain->threads);
+	pthread_mutex_unlock(&domain->lock);
+}
+
+// 注销读者线程，调用时不能在读临界区内
+static inline void epoch_thread_unregister(struct epoch_thread *thread)
+{
+	struct epoch_domain *domain = thread->domain;
+
+	pthread_mutex_lock(&domain->lock);
+	list_delete_entry(&thread->node);
+	pthread_mutex_unlock(&domain->lock);
+}
+
+// 进入读临界区，可嵌套
+static inline void epoch_read_lock(struct epoch_thread *thread)
+{
+	if (thread->nest++ == 0) {
+		uint64_t epoch = __atomic_load_n(&thread->domain->epoch, __ATOMIC_RELAXED);
+
+		__atomic_store_n(&thread->local, (epoch << 1) | 1, __ATOMIC_RELAXED);
+		if (thread->domain->membarrier)
+			__atomic_signal_fence(__ATOMIC_SEQ_CST);
+		else
+			__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	}
+}
+
+// 退出读临界区
+static inline void epoch_read_unlock(struct epoch_thread *thread)
+{
+	if (--thread->nest == 0)
+		__atomic_store_n(&thread->local, 0, __ATOMIC_RELEASE);
+}
+
+/*
+ * 延迟执行 func(head)，直到当前所有读者都离开临界区
+ * 写者在 list_del_rcu/list_replace_rcu 摘除节点后调用，不能在读临界区内调用
+ */
+static inline void epoch_call(struct epoch_domain *domain, struct epoch_head *head,
+			      void (*func)(struct epoch_head *head))
+{
+	struct epoch_head *list = NULL;
+	int advanced;
+
+	head->func = func;
+
+	pthread_mutex_lock(&domain->lock);
+	head->next_ptr = domain->limbo[domain->epoch % EPOCH_LIMBO_COUNT];
+	domain->limbo[domain->epoch % EPOCH_LIMBO_COUNT] = head;
+	if (++domain->pending >= EPOCH_RECLAIM_BATCH)
+		list = epoch_try_advance(domain, &advanced);
+	pthread_mutex_unlock(&domain->lock);
+
+	epoch_run_callbacks(list);
+}
+
+/*
+ * 等待调用前挂入的所有对象回收完毕，不能在读临界区内调用
+ */
+static inline void epoch_synchronize(struct epoch_domain *domain)
+{
+	uint64_t target;
+
+	pthread_mutex_lock(&domain->lock);
+	target = domain->epoch + 2;
+	pthread_mutex_unlock(&domain->lock);
+
+	while (1) {
+		struct epoch_head *list = NULL;
+		int advanced = 0;
+		int done;
+
+		pthread_mutex_lock(&domain->lock);
+		done = domain->epoch >= target;
+		if (!done)
+			list = epoch_try_advance(domain, &advanced);
+		pthread_mutex_unlock(&domain->lock);
+
+		epoch_run_callbacks(list);
+		if (done)
+			break;
+		if (!advanced)
+			sched_yield();
+	}
+}
+
+#endif /* __EPOCH_H__ */
@@ -0,0 +1,179 @@
+#ifndef __HTABLE_H__
+#define __HTABLE_H__
+
+#include <stdlib.h>
+#include <string.h>
+#include "list.h"
+
+#define HTABLE_MIN_BUCKETS	16
+#define HTABLE_MIGRATE_STEP	8	// 每次修改操作最多迁移的旧桶数量
+
+/*
+ * 侵入式哈希表节点，嵌入到数据结构体中，用 hlist_entry/list_entry 取回数据节点。
+ * 保存完整的哈希值，扩容迁移时不需要重新计算。
+ */
+struct htable_node {
+	struct hlist_node node;
+	uint64_t hash;
+};
+
+/*
+ * 开链哈希表，桶为单指针的 hlist_head，元素数量超过桶数量时扩容为两倍。
+ * 扩容是渐进的：新桶数组分配后旧数组保留，之后每次插入/删除迁移 HTABLE_MIGRATE_STEP 个旧桶，
+ * 查找同时检查新旧两个桶，不会因为一次扩容阻塞调用者。
+ * 节点内存由调用者管理，哈希表不做任何节点分配；本身不加锁，多线程访问由调用者保护。
+ */
+struct htable {
+	struct hlist_head *buckets;	// 当前桶数组
+	size_t mask;			// 当前桶数量 - 1
+	struct hlist_head *old_buckets;	// 迁移中的旧桶数组，没有迁移时为 NULL
+	size_t old_mask;		// 旧桶数量 - 1
+	size_t migrate_pos;		// 下一个待迁移的旧桶下标
+	size_t count;			// 元素数量
+};
+
+// 比较节点与查找键，相等返回非0
+typedef int (*htable_eq_t)(const struct htable_node *node, const void *key);
+
+/*
+ * 64位整数哈希 (splitmix64 的混合函数)，用于整数键或组合哈希
+ */
+static inline uint64_t htable_hash_u64(uint64_t key)
+{
+	key ^= key >> 30;
+	key *= 0xbf58476d1ce4e5b9ULL;
+	key ^= key >> 27;
+	key *= 0x94d049bb133111ebULL;
+	key ^= key >> 31;
+	return key;
+}
+
+/*
+ * 字节串哈希 (FNV-1a 后再混合一次，使高位也足够随机)
+ */
+static inline uint64_t htable_hash_bytes(const void *data, size_t length)
+{
+	const uint8_t *p = (const uint8_t *)data;
+	uint64_t hash = 0xcbf29ce484222325ULL;
+
+	for (size_t i = 0; i < length; ++i) {
+		hash ^= p[i];
+		hash *= 0x100000001b3ULL;
+	}
+	return htable_hash_u64(hash);
+}
+
+// 初始化哈希表，nbuckets 向上取整为2的幂，成功返回0，内存不足返回-1
+static inline int htable_init(struct htable *ht, size_t nbuckets)
+{
+	size_t size = HTABLE_MIN_BUCKETS;
+
+	while (size < nbuckets)
+		size <<= 1;
+
+	memset(ht, 0, sizeof(*ht));
+	ht->buckets = (struct hlist_head *)calloc(size, sizeof(struct hlist_head));
+	if (!ht->buckets)
+		return -1;
+	ht->mask = size - 1;
+	return 0;
+}
+
+// 释放桶数组，节点由调用者释放
+static inline void htable_destroy(struct htable *ht)
+{
+	free(ht->buckets);
+	free(ht->old_buckets);
+	memset(ht, 0, sizeof(*ht));
+}
+
+// 迁移最多 steps 个旧桶，全部迁移完成后释放旧桶数组
+static inline void htable_migrate(struct htable *ht, size_t steps)
+{
+	struct htable_node *pos;
+	struct hlist_node *n;
+
+	while (ht->old_buckets && steps--) {
+		struct hlist_head *old = &ht->old_buckets[ht->migrate_pos];
+
+		hlist_for_each_entry_safe(pos, n, old, node) {
+			hlist_delete_entry(&pos->node);
+			hlist_add_head(&pos->node, &ht->buckets[pos->hash & ht->mask]);
+		}
+
+		if (++ht->migrate_pos > ht->old_mask) {
+			free(ht->old_buckets);
+			ht->old_buckets = NULL;
+			ht->old_mask = 0;
+			ht->migrate_pos = 0;
+		}
+	}
+}
+
+// 开始扩容，上一次扩容未完成时先把它迁移完；内存不足时保持原桶数，只是链变长
+static inline void htable_grow(struct htable *ht)
+{
+	size_t size = (ht->mask + 1) << 1;
+	struct hlist_head *buckets;
+
+	htable_migrate(ht, ht->old_mask + 1);
+
+	buckets = (struct hlist_head *)calloc(size, sizeof(struct hlist_head));
+	if (!buckets)
+		return;
+
+	ht->old_buckets = ht->buckets;
+	ht->old_mask = ht->mask;
+	ht->migrate_pos = 0;
+	ht->buckets = buckets;
+	ht->mask = size - 1;
+}
+
+// 查找节点，不存在返回 NULL
+static inline struct htable_node *htable_find(const struct htable *ht, uint64_t hash,
+					      htable_eq_t eq, const void *key)
+{
+	struct htable_node *pos;
+
+	hlist_for_each_entry(pos, &ht->buckets[hash & ht->mask], node) {
+		if (pos->hash == hash && eq(pos, key))
+			return pos;
+	}
+
+	// 尚未迁移的旧桶
+	if (ht->old_buckets && (hash & ht->old_mask) >= ht->migrate_pos) {
+		hlist_for_each_entry(pos, &ht->old_buckets[hash & ht->old_mask], node) {
+			if (pos->hash == hash && eq(pos, key))
+				return pos;
+		}
+	}
+
+	return NULL;
+}
+
+// 插入节点，不检查重复键，需要唯一性时先调用 htable_find
+static inline void htable_insert(struct htable *ht, struct htable_node *node, uint64_t hash)
+{
+	htable_migrate(ht, HTABLE_MIGRATE_STEP);
+
+	if (ht->count > ht->mask)
+		htable_grow(ht);
+
+	node->hash = hash;
+	hlist_add_head(&node->node, &ht->buckets[hash & ht->mask]);
+	++ht->count;
+}
+
+// 删除节点，节点必须在本哈希表中
+static inline void htable_remove(struct htable *ht, struct htable_node *node)
+{
+	hlist_delete_entry(&node->node);
+	--ht->count;
+
+	htable_migrate(ht, HTABLE_MIGRATE_STEP);
+}
+
+// 获取元素数量
+#define htable_count(ht) ((ht)->count)
+
+#endif /* __HTABLE_H__ */
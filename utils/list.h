@@ -2,6 +2,7 @@
 #define __LIST_H__
 
 #include <stddef.h>
+#include <stdint.h>
 
 // 初始化节点，将 name 的前驱和后继几点都指向本身
 #define LIST_HEAD_INIT(name) { &(name), &(name) }
@@ -185,5 +186,296 @@ static inline void list_delete_entry(struct list_head *entry)
 	entry->prev_ptr->next_ptr = entry->next_ptr;
 }
 
+/*
+ * RCU 风格的读多写少链表操作
+ * 写者之间仍需加锁互斥；读者不加锁，在 epoch_read_lock/epoch_read_unlock (epoch.h) 之间
+ * 用 list_for_each_entry_rcu 遍历。节点发布时先初始化好再以 release 语义链入，
+ * 摘除后节点的 next_ptr 保持不变，正在访问它的读者仍能继续遍历，
+ * 节点内存必须经 epoch_call 延迟到所有读者离开后再释放。
+ */
+
+// 读取被 RCU 保护的指针
+#define list_rcu_dereference(p) __atomic_load_n(&(p), __ATOMIC_CONSUME)
+
+// 发布指针，之前对节点的初始化对读者可见
+#define list_rcu_assign_pointer(p, v) __atomic_store_n(&(p), (v), __ATOMIC_RELEASE)
+
+// 遍历 RCU 链表，只能在读临界区内使用
+#define list_for_each_entry_rcu(pos, head, member) \
+	for (pos = list_entry(list_rcu_dereference((head)->next_ptr), typeof(*pos), member); \
+	     &pos->member != (head); \
+	     pos = list_entry(list_rcu_dereference(pos->member.next_ptr), typeof(*pos), member))
+
+// 将 new_ptr 节点发布到 prev_ptr 和 next_ptr 之间
+static inline void list_insert_rcu(struct list_head *new_ptr,
+				   struct list_head *prev_ptr,
+				   struct list_head *next_ptr)
+{
+	new_ptr->next_ptr = next_ptr;
+	new_ptr->prev_ptr = prev_ptr;
+	list_rcu_assign_pointer(prev_ptr->next_ptr, new_ptr);
+	next_ptr->prev_ptr = new_ptr;
+}
+
+// 发布 new_ptr 节点到链表头部
+static inline void list_add_rcu(struct list_head *new_ptr, struct list_head *head)
+{
+	list_insert_rcu(new_ptr, head, head->next_ptr);
+}
+
+// 发布 new_ptr 节点到链表尾部
+static inline void list_add_tail_rcu(struct list_head *new_ptr, struct list_head *head)
+{
+	list_insert_rcu(new_ptr, head->prev_ptr, head);
+}
+
+// 摘除 entry 节点，保留 entry->next_ptr 供正在遍历的读者使用
+static inline void list_del_rcu(struct list_head *entry)
+{
+	entry->next_ptr->prev_ptr = entry->prev_ptr;
+	list_rcu_assign_pointer(entry->prev_ptr->next_ptr, entry->next_ptr);
+	entry->prev_ptr = NULL;
+}
+
+// 用 new_ptr 原地替换 old 节点，读者看到的要么是旧节点要么是新节点
+static inline void list_replace_rcu(struct list_head *old, struct list_head *new_ptr)
+{
+	new_ptr->next_ptr = old->next_ptr;
+	new_ptr->prev_ptr = old->prev_ptr;
+	list_rcu_assign_pointer(new_ptr->prev_ptr->next_ptr, new_ptr);
+	new_ptr->next_ptr->prev_ptr = new_ptr;
+	old->prev_ptr = NULL;
+}
+
+/*
+ * 单指针表头的双向链表，用于哈希桶。
+ * 表头只有一个 first 指针，桶数组的内存占用减半；节点的 pprev_ptr 指向前一个节点的
+ * next_ptr (或表头的 first)，删除时不需要知道表头。
+ */
+struct hlist_node {
+	struct hlist_node *next_ptr, **pprev_ptr;
+};
+
+struct hlist_head {
+	struct hlist_node *first;
+};
+
+#define HLIST_HEAD_INIT { NULL }
+
+#define HLIST_HEAD(name) \
+	struct hlist_head name = HLIST_HEAD_INIT
+
+#define hlist_entry(ptr, type, member) \
+	((type *)((char *)(ptr) - offsetof(type, member)))
+
+#define hlist_entry_safe(ptr, type, member) \
+	({ typeof(ptr) ____ptr = (ptr); \
+	   ____ptr ? hlist_entry(____ptr, type, member) : NULL; })
+
+// 检查哈希链是否为空
+#define hlist_empty(head) ((head)->first == NULL)
+
+// 遍历哈希链
+#define hlist_for_each_entry(pos, head, member) \
+	for (pos = hlist_entry_safe((head)->first, typeof(*(pos)), member); \
+	     pos; \
+	     pos = hlist_entry_safe((pos)->member.next_ptr, typeof(*(pos)), member))
+
+// 遍历哈希链，遍历过程中可以删除 pos，n 为 struct hlist_node * 临时变量
+#define hlist_for_each_entry_safe(pos, n, head, member) \
+	for (pos = hlist_entry_safe((head)->first, typeof(*(pos)), member); \
+	     pos && ({ n = (pos)->member.next_ptr; 1; }); \
+	     pos = hlist_entry_safe(n, typeof(*(pos)), member))
+
+// 初始化哈希链表头
+static inline void init_hlist_head(struct hlist_head *head)
+{
+	head->first = NULL;
+}
+
+// 初始化哈希链节点
+static inline void init_hlist_node(struct hlist_node *node)
+{
+	node->next_ptr = NULL;
+	node->pprev_ptr = NULL;
+}
+
+// 检查节点是否在哈希链上
+static inline int hlist_unhashed(const struct hlist_node *node)
+{
+	return node->pprev_ptr == NULL;
+}
+
+// 添加节点到哈希链头部
+static inline void hlist_add_head(struct hlist_node *node, struct hlist_head *head)
+{
+	struct hlist_node *first = head->first;
+
+	node->next_ptr = first;
+	if (first)
+		first->pprev_ptr = &node->next_ptr;
+	head->first = node;
+	node->pprev_ptr = &head->first;
+}
+
+// 从哈希链删除节点，删除后节点处于未挂链状态
+static inline void hlist_delete_entry(struct hlist_node *node)
+{
+	struct hlist_node *next = node->next_ptr;
+
+	*node->pprev_ptr = next;
+	if (next)
+		next->pprev_ptr = node->pprev_ptr;
+	init_hlist_node(node);
+}
+
+/*
+ * 以下为无锁的侵入式结构，用法与 list_head 相同：把节点嵌入数据结构体，
+ * 出队后用 list_entry 取回数据节点。同步使用 GCC __atomic 内建函数。
+ */
+
+// MPSC 队列节点
+struct mpsc_node {
+	struct mpsc_node *next_ptr;
+};
+
+/*
+ * Vyukov 多生产者单消费者队列
+ * head_ptr 为生产者竞争的入队端，tail_ptr 只由消费者访问，stub 为队列为空时的占位节点。
+ * 入队只有一次原子交换，任意线程可调用且不会失败；出队只能由一个消费者线程调用。
+ */
+struct mpsc_head {
+	struct mpsc_node *head_ptr;
+	struct mpsc_node *tail_ptr;
+	struct mpsc_node stub;
+};
+
+// 初始化 MPSC 队列
+static inline void init_mpsc_head(struct mpsc_head *q)
+{
+	q->stub.next_ptr = NULL;
+	q->head_ptr = &q->stub;
+	q->tail_ptr = &q->stub;
+}
+
+// 入队，可由任意线程并发调用
+static inline void mpsc_push(struct mpsc_head *q, struct mpsc_node *node)
+{
+	struct mpsc_node *prev;
+
+	__atomic_store_n(&node->next_ptr, NULL, __ATOMIC_RELAXED);
+	prev = __atomic_exchange_n(&q->head_ptr, node, __ATOMIC_ACQ_REL);
+	__atomic_store_n(&prev->next_ptr, node, __ATOMIC_RELEASE);
+}
+
+/*
+ * 出队，只能由消费者线程调用
+ * 返回 NULL 表示队列为空；若某个生产者正处于交换与链接之间，
+ * 其后的节点暂时不可见，也会返回 NULL，稍后重试即可取到。
+ */
+static inline struct mpsc_node *mpsc_pop(struct mpsc_head *q)
+{
+	struct mpsc_node *tail = q->tail_ptr;
+	struct mpsc_node *next = __atomic_load_n(&tail->next_ptr, __ATOMIC_ACQUIRE);
+
+	if (tail == &q->stub) {
+		if (next == NULL)
+			return NULL;
+		q->tail_ptr = next;
+		tail = next;
+		next = __atomic_load_n(&tail->next_ptr, __ATOMIC_ACQUIRE);
+	}
+
+	if (next != NULL) {
+		q->tail_ptr = next;
+		return tail;
+	}
+
+	// tail 是最后一个可见节点，只有它同时也是 head 时才能取出
+	if (tail != __atomic_load_n(&q->head_ptr, __ATOMIC_ACQUIRE))
+		return NULL;
+
+	mpsc_push(q, &q->stub);
+
+	next = __atomic_load_n(&tail->next_ptr, __ATOMIC_ACQUIRE);
+	if (next != NULL) {
+		q->tail_ptr = next;
+		return tail;
+	}
+
+	return NULL;
+}
+
+// 检查 MPSC 队列是否为空，只能由消费者线程调用
+static inline int mpsc_empty(struct mpsc_head *q)
+{
+	return q->tail_ptr == &q->stub &&
+	       __atomic_load_n(&q->stub.next_ptr, __ATOMIC_ACQUIRE) == NULL &&
+	       __atomic_load_n(&q->head_ptr, __ATOMIC_ACQUIRE) == &q->stub;
+}
+
+// Treiber 栈节点
+struct stack_node {
+	struct stack_node *next_ptr;
+};
+
+/*
+ * 带 ABA 标记的 Treiber 无锁栈，可多线程并发 push/pop
+ * 栈顶指针与修改计数打包在一个64位字中：64位平台上用户态地址只占低48位，
+ * 高16位存放计数；32位平台上高32位存放计数。每次修改计数加一，
+ * 节点被弹出后又压回同一地址时 CAS 会因计数不同而失败。
+ * pop 会读取栈顶节点的 next_ptr，节点内存在栈的生命周期内不能归还给系统
+ * (例如来自对象池或只在栈销毁后释放)。
+ */
+struct stack_head {
+	uint64_t top;
+};
+
+#define STACK_TAG_SHIFT		(sizeof(void *) == 8 ? 48 : 32)
+#define STACK_PTR_MASK		((1ULL << STACK_TAG_SHIFT) - 1)
+
+#define stack_top_ptr(top)	((struct stack_node *)(uintptr_t)((top) & STACK_PTR_MASK))
+#define stack_top_make(ptr, top) \
+	((uint64_t)(uintptr_t)(ptr) | ((((top) >> STACK_TAG_SHIFT) + 1) << STACK_TAG_SHIFT))
+
+#define STACK_HEAD_INIT { 0 }
+
+// 初始化栈
+static inline void init_stack_head(struct stack_head *s)
+{
+	s->top = 0;
+}
+
+// 压栈
+static inline void stack_push(struct stack_head *s, struct stack_node *node)
+{
+	uint64_t top = __atomic_load_n(&s->top, __ATOMIC_RELAXED);
+
+	do {
+		__atomic_store_n(&node->next_ptr, stack_top_ptr(top), __ATOMIC_RELAXED);
+	} while (!__atomic_compare_exchange_n(&s->top, &top, stack_top_make(node, top), 1,
+					      __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+// 出栈，栈为空返回 NULL
+static inline struct stack_node *stack_pop(struct stack_head *s)
+{
+	uint64_t top = __atomic_load_n(&s->top, __ATOMIC_ACQUIRE);
+	struct stack_node *node;
+
+	do {
+		node = stack_top_ptr(top);
+		if (node == NULL)
+			return NULL;
+	} while (!__atomic_compare_exchange_n(&s->top, &top,
+					      stack_top_make(__atomic_load_n(&node->next_ptr, __ATOMIC_RELAXED), top),
+					      1, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE));
+
+	return node;
+}
+
+// 检查栈是否为空
+#define stack_empty(s) (stack_top_ptr(__atomic_load_n(&(s)->top, __ATOMIC_RELAXED)) == NULL)
+
 
 #endif /* __LIST_H__ */
\ No newline at end of file
@@ -0,0 +1,256 @@
+#ifndef __LRU_CACHE_H__
+#define __LRU_CACHE_H__
+
+#include <errno.h>
+#include <pthread.h>
+#include "htable.h"
+
+#define LRU_CACHE_MAX_STRIPES	256
+
+// 淘汰策略
+enum lru_policy {
+	LRU_POLICY_LRU,		// 命中时移到链表头部，淘汰链表尾部
+	LRU_POLICY_CLOCK,	// 命中时只置访问位，淘汰时从尾部扫描，访问过的给第二次机会
+};
+
+/*
+ * 缓存节点，嵌入到数据结构体中，用 list_entry 取回数据节点。
+ * refcnt 由 lru_cache_get/lru_cache_put 维护，被引用的节点不会被淘汰或删除。
+ */
+struct lru_node {
+	struct htable_node hnode;
+	struct list_head lnode;		// 最近使用链表，头部最新
+	uint32_t refcnt;		// 引用计数
+	uint32_t referenced;		// CLOCK 访问位
+};
+
+// 缓存分片，每个分片独占一个 cache line 起始位置，分片之间没有锁竞争
+struct lru_stripe {
+	pthread_mutex_t lock;
+	struct htable table;
+	struct list_head list;
+	size_t capacity;
+} __attribute__((aligned(64)));
+
+/*
+ * 分片加锁的侵入式 LRU/CLOCK 缓存
+ * 按哈希值高位选择分片，每个分片有独立的锁、哈希表和最近使用链表，容量平均分配到各分片。
+ * 缓存本身不分配节点：调用者准备好节点后插入，被淘汰的节点交还调用者释放或复用。
+ * 哈希值需要高低位都足够随机，可使用 htable_hash_u64/htable_hash_bytes。
+ */
+struct lru_cache {
+	struct lru_stripe *stripes;
+	uint32_t stripe_mask;
+	int policy;
+	htable_eq_t eq;
+};
+
+#define lru_cache_stripe(cache, hash) \
+	(&(cache)->stripes[((hash) >> 40) & (cache)->stripe_mask])
+
+/*
+ * 初始化缓存
+ * capacity 总容量，nstripes 分片数量 (向上取整为2的幂)，policy 淘汰策略，eq 键比较函数
+ * 成功返回0，参数错误或内存不足返回-1
+ */
+static inline int lru_cache_init(struct lru_cache *cache, size_t capacity, uint32_t nstripes,
+				 int policy, htable_eq_t eq)
+{
+	uint32_t count = 1;
+
+	if (capacity == 0 || nstripes == 0 || nstripes > LRU_CACHE_MAX_STRIPES || !eq)
+		return -1;
+
+	while (count < nstripes)
+		count <<= 1;
+
+	void *mem = NULL;
+	if (posix_memalign(&mem, 64, count * sizeof(struct lru_stripe)) != 0)
+		return -1;
+
+	cache->stripes = (struct lru_stripe *)mem;
+	cache->stripe_mask = count - 1;
+	cache->policy = policy;
+	cache->eq = eq;
+
+	for (uint32_t i = 0; i < count; ++i) {
+		struct lru_stripe *stripe = &cache->stripes[i];
+
+		if (htable_init(&stripe->table, (capacity + count - 1) / count) != 0) {
+			while (i--) {
+				pthread_mutex_destroy(&cache->stripes[i].lock);
+				htable_destroy(&cache->stripes[i].table);
+			}
+			free(mem);
+			return -1;
+		}
+		pthread_mutex_init(&stripe->lock, NULL);
+		init_list_head(&stripe->list);
+		stripe->capacity = (capacity + count - 1) / count;
+	}
+
+	return 0;
+}
+
+/*
+ * 销毁缓存，release 非空时对每个剩余节点调用一次，由调用者释放节点
+ */
+static inline void lru_cache_destroy(struct lru_cache *cache, void (*release)(struct lru_node *node))
+{
+	struct lru_node *pos, *n;
+
+	for (uint32_t i = 0; i <= cache->stripe_mask; ++i) {
+		struct lru_stripe *stripe = &cache->stripes[i];
+
+		list_for_each_entry_safe(pos, n, &stripe->list, lnode) {
+			list_delete_entry(&pos->lnode);
+			if (release)
+				release(pos);
+		}
+		htable_destroy(&stripe->table);
+		pthread_mutex_destroy(&stripe->lock);
+	}
+
+	free(cache->stripes);
+	cache->stripes = NULL;
+}
+
+/*
+ * 在分片内选出一个淘汰节点，调用时持有分片锁
+ * 跳过被引用的节点；CLOCK 策略下访问位为1的节点清零后移到头部，给第二次机会
+ */
+static inline struct lru_node *lru_stripe_evict(struct lru_stripe *stripe, int policy)
+{
+	size_t scan = htable_count(&stripe->table) * 2;
+
+	while (scan-- && !list_empty(&stripe->list)) {
+		struct lru_node *victim = list_last_entry(&stripe->list, struct lru_node, lnode);
+
+		if (__atomic_load_n(&victim->refcnt, __ATOMIC_ACQUIRE) == 0 &&
+		    (policy != LRU_POLICY_CLOCK || !victim->referenced)) {
+			list_delete_entry(&victim->lnode);
+			htable_remove(&stripe->table, &victim->hnode);
+			return victim;
+		}
+
+		victim->referenced = 0;
+		list_delete_entry(&victim->lnode);
+		list_add_head(&victim->lnode, &stripe->list);
+	}
+
+	return NULL;
+}
+
+/*
+ * 查找并引用节点，使用完后必须调用 lru_cache_put
+ * 不存在返回 NULL
+ */
+static inline struct lru_node *lru_cache_get(struct lru_cache *cache, uint64_t hash, const void *key)
+{
+	struct lru_stripe *stripe = lru_cache_stripe(cache, hash);
+	struct lru_node *node = NULL;
+	struct htable_node *hnode;
+
+	pthread_mutex_lock(&stripe->lock);
+	hnode = htable_find(&stripe->table, hash, cache->eq, key);
+	if (hnode) {
+		node = list_entry(hnode, struct lru_node, hnode);
+		__atomic_add_fetch(&node->refcnt, 1, __ATOMIC_RELAXED);
+		if (cache->policy == LRU_POLICY_CLOCK) {
+			node->referenced = 1;
+		} else {
+			list_delete_entry(&node->lnode);
+			list_add_head(&node->lnode, &stripe->list);
+		}
+	}
+	pthread_mutex_unlock(&stripe->lock);
+
+	return node;
+}
+
+/*
+ * 释放 lru_cache_get 取得的引用，不需要加锁
+ */
+static inline void lru_cache_put(struct lru_node *node)
+{
+	__atomic_sub_fetch(&node->refcnt, 1, __ATOMIC_RELEASE);
+}
+
+/*
+ * 插入节点
+ * 键已存在返回 -EEXIST，节点未插入；成功返回0。
+ * 分片超出容量时淘汰一个未被引用的节点并通过 evicted 返回，没有淘汰时 evicted 为 NULL。
+ * 所有节点都被引用时暂时超出容量，下一次插入再淘汰。
+ */
+static inline int lru_cache_insert(struct lru_cache *cache, struct lru_node *node, uint64_t hash,
+				   const void *key, struct lru_node **evicted)
+{
+	struct lru_stripe *stripe = lru_cache_stripe(cache, hash);
+
+	*evicted = NULL;
+	node->refcnt = 0;
+	node->referenced = 0;
+
+	pthread_mutex_lock(&stripe->lock);
+	if (htable_find(&stripe->table, hash, cache->eq, key)) {
+		pthread_mutex_unlock(&stripe->lock);
+		return -EEXIST;
+	}
+
+	if (htable_count(&stripe->table) >= stripe->capacity)
+		*evicted = lru_stripe_evict(stripe, cache->policy);
+
+	htable_insert(&stripe->table, &node->hnode, hash);
+	list_add_head(&node->lnode, &stripe->list);
+	pthread_mutex_unlock(&stripe->lock);
+
+	return 0;
+}
+
+/*
+ * 删除节点，成功时通过 removed 返回节点交还调用者
+ * 不存在返回 -ENOENT，节点正在被引用返回 -EBUSY
+ */
+static inline int lru_cache_erase(struct lru_cache *cache, uint64_t hash, const void *key,
+				  struct lru_node **removed)
+{
+	struct lru_stripe *stripe = lru_cache_stripe(cache, hash);
+	struct htable_node *hnode;
+	int ret = 0;
+
+	*removed = NULL;
+
+	pthread_mutex_lock(&stripe->lock);
+	hnode = htable_find(&stripe->table, hash, cache->eq, key);
+	if (!hnode) {
+		ret = -ENOENT;
+	} else {
+		struct lru_node *node = list_entry(hnode, struct lru_node, hnode);
+
+		if (__atomic_load_n(&node->refcnt, __ATOMIC_ACQUIRE) != 0) {
+			ret = -EBUSY;
+		} else {
+			list_delete_entry(&node->lnode);
+			htable_remove(&stripe->table, &node->hnode);
+			*removed = node;
+		}
+	}
+	pthread_mutex_unlock(&stripe->lock);
+
+	return ret;
+}
+
+/*
+ * 获取缓存元素数量，结果只是一个快照
+ */
+static inline size_t lru_cache_count(struct lru_cache *cache)
+{
+	size_t count = 0;
+
+	for (uint32_t i = 0; i <= cache->stripe_mask; ++i)
+		count += __atomic_load_n(&cache->stripes[i].table.count, __ATOMIC_RELAXED);
+
+	return count;
+}
+
+#endif /* __LRU_CACHE_H__ */
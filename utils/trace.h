@@ -0,0 +1,319 @@
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <atomic>
+#include <mutex>
+#include <new>
+
+/**
+/*@brief 任务生命周期追踪
+/*
+/* 定义 ENABLE_TRACE 后 threadpool_t 和 BlockQueue 在入队、出队、开始、结束时记录事件，
+/* 未定义时 TRACE_* 宏展开为空，不产生任何代码。编译期打开后还需调用 trace_start 才开始记录，
+/* 未开始时每个钩子只多一次原子读。同一程序内所有包含 BlockQueue.h 的文件必须使用相同的 ENABLE_TRACE 设置。
+/*
+/* 每个线程第一次记录时创建自己的事件环形缓存区，只有该线程写入，写满后覆盖最旧的事件，记录不加锁。
+/* trace_dump_chrome 可在任意时刻把所有线程缓存中的事件写成 Chrome trace JSON，
+/* 用 chrome://tracing 或 ui.perfetto.dev 打开：入队到出队之间用 flow 箭头连接，
+/* 队列深度显示为计数器，任务执行显示为工作线程上的时间片。
+*/
+
+#ifndef TRACE_BUFFER_EVENTS
+#define TRACE_BUFFER_EVENTS     16384   //每个线程缓存的事件数量，必须为2的幂
+#endif
+
+/**
+/*@brief 事件类型
+/*
+*/
+typedef enum trace_phase_t
+{
+    TRACE_ENQUEUE,      //对象入队，value 为入队后的队列深度
+    TRACE_DEQUEUE,      //对象出队，与 id 相同的 TRACE_ENQUEUE 配对
+    TRACE_START,        //开始处理
+    TRACE_FINISH,       //处理结束，与同一线程上一个 TRACE_START 配对
+} trace_phase_t;
+
+/**
+/*@brief 一条事件
+/*
+*/
+typedef struct trace_event_t
+{
+    uint64_t        ts;         //CLOCK_MONOTONIC 纳秒
+    const void      *obj;       //所属的队列或线程池
+    uint64_t        id;         //对象在 obj 内的编号，用于配对入队与出队
+    const char      *name;      //事件名称，必须是静态字符串
+    uint32_t        phase;
+    uint32_t        value;
+} trace_event_t;
+
+/**
+/*@brief 线程事件缓存区
+/*
+*/
+typedef struct trace_buffer_t
+{
+    std::atomic<uint64_t>   head;       //已写入的事件总数
+    pid_t                   tid;
+    char                    thread_name[32];
+    struct trace_buffer_t   *next;      //所有缓存区串成链表，进程退出前不释放
+    trace_event_t           events[TRACE_BUFFER_EVENTS];
+} trace_buffer_t;
+
+/**
+/*@brief 开始记录事件
+/*
+*/
+static inline void trace_start(void);
+
+/**
+/*@brief 停止记录事件，已记录的事件保留
+/*
+*/
+static inline void trace_stop(void);
+
+/**
+/*@brief 是否正在记录事件
+/*
+*/
+static inline bool trace_enabled(void);
+
+/**
+/*@brief 在当前线程记录一条事件，一般通过 TRACE_EVENT 宏调用
+/*
+/*@param phase 事件类型
+/*@param name 事件名称，必须是静态字符串
+/*@param obj 所属的队列或线程池
+/*@param id 对象编号
+/*@param value 附加数值
+*/
+static inline void trace_record(trace_phase_t phase, const char *name, const void *obj, uint64_t id, uint32_t value);
+
+/**
+/*@brief 设置当前线程在追踪结果中显示的名称
+/*
+/*@param name 线程名称
+*/
+static inline void trace_set_thread_name(const char *name);
+
+/**
+/*@brief 把所有线程缓存中的事件写成 Chrome trace JSON
+/*
+/* 可以在记录过程中调用，正在被覆盖的事件会被跳过
+/*
+/*@param path 输出文件路径
+/*@return int 成功返回写出的事件数量，失败返回-1
+*/
+static inline int trace_dump_chrome(const char *path);
+
+#ifdef ENABLE_TRACE
+#define TRACE_EVENT(phase, name, obj, id, value)                                    \
+    do                                                                              \
+    {                                                                               \
+        if (trace_enabled())                                                        \
+        {                                                                           \
+            trace_record((phase), (name), (obj), (uint64_t)(id), (uint32_t)(value));\
+        }                                                                           \
+    } while (0)
+#define TRACE_THREAD_NAME(name) trace_set_thread_name(name)
+#else
+#define TRACE_EVENT(phase, name, obj, id, value) do {} while (0)
+#define TRACE_THREAD_NAME(name) do {} while (0)
+#endif
+
+/**
+/*@brief 进程内共享的追踪状态
+/*
+/* 放在 inline 函数的静态变量中，所有编译单元共用同一份
+*/
+struct trace_state_t
+{
+    std::atomic<bool>       enabled;
+    std::mutex              mutex;      //只保护缓存区链表的插入和遍历
+    trace_buffer_t          *buffers;
+};
+
+inline trace_state_t &trace_state(void)
+{
+    static trace_state_t state{{false}, {}, nullptr};
+    return state;
+}
+
+inline trace_buffer_t *&trace_local_buffer(void)
+{
+    static thread_local trace_buffer_t *buffer = nullptr;
+    return buffer;
+}
+
+static inline uint64_t trace_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static inline trace_buffer_t *trace_get_buffer(void)
+{
+    trace_buffer_t *&buffer = trace_local_buffer();
+    if (buffer)
+    {
+        return buffer;
+    }
+
+    buffer = new (std::nothrow) trace_buffer_t;
+    if (!buffer)
+    {
+        return nullptr;
+    }
+    buffer->head.store(0, std::memory_order_relaxed);
+    buffer->tid = (pid_t)syscall(SYS_gettid);
+    snprintf(buffer->thread_name, sizeof(buffer->thread_name), "thread %d", (int)buffer->tid);
+
+    trace_state_t &state = trace_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    buffer->next = state.buffers;
+    state.buffers = buffer;
+    return buffer;
+}
+
+static inline void trace_start(void)
+{
+    trace_state().enabled.store(true, std::memory_order_release);
+}
+
+static inline void trace_stop(void)
+{
+    trace_state().enabled.store(false, std::memory_order_release);
+}
+
+static inline bool trace_enabled(void)
+{
+    return trace_state().enabled.load(std::memory_order_relaxed);
+}
+
+static inline void trace_record(trace_phase_t phase, const char *name, const void *obj, uint64_t id, uint32_t value)
+{
+    trace_buffer_t *buffer = trace_get_buffer();
+    if (!buffer)
+    {
+        return;
+    }
+
+    uint64_t head = buffer->head.load(std::memory_order_relaxed);
+    trace_event_t *event = &buffer->events[head & (TRACE_BUFFER_EVENTS - 1)];
+    event->ts = trace_now_ns();
+    event->obj = obj;
+    event->id = id;
+    event->name = name;
+    event->phase = phase;
+    event->value = value;
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+static inline void trace_set_thread_name(const char *name)
+{
+    trace_buffer_t *buffer = trace_get_buffer();
+    if (buffer)
+    {
+        snprintf(buffer->thread_name, sizeof(buffer->thread_name), "%s %d", name, (int)buffer->tid);
+    }
+}
+
+/**
+/*@brief 写出一条事件，入队/出队写成零长度时间片加 flow 端点和深度计数器，开始/结束写成 B/E
+/*
+*/
+static inline void trace_write_event(FILE *fp, int pid, const trace_buffer_t *buffer, const trace_event_t *event)
+{
+    double ts = event->ts / 1000.0;    //Chrome trace 以微秒为单位
+
+    switch (event->phase)
+    {
+    case TRACE_ENQUEUE:
+    case TRACE_DEQUEUE:
+    {
+        bool enqueue = event->phase == TRACE_ENQUEUE;
+        fprintf(fp, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"dur\":0,\"ts\":%.3f,\"pid\":%d,\"tid\":%d,"
+                    "\"args\":{\"obj\":\"%p\",\"id\":%llu,\"depth\":%u}}",
+                enqueue ? "enqueue" : "dequeue", event->name, ts, pid, (int)buffer->tid,
+                event->obj, (unsigned long long)event->id, event->value);
+        fprintf(fp, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%s\",%s\"id\":\"%p:%llu\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d}",
+                event->name, event->name, enqueue ? "s" : "f", enqueue ? "" : "\"bp\":\"e\",",
+                event->obj, (unsigned long long)event->id, ts, pid, (int)buffer->tid);
+        fprintf(fp, ",\n{\"name\":\"%s %p depth\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":%d,\"args\":{\"depth\":%u}}",
+                event->name, event->obj, ts, pid, event->value);
+        break;
+    }
+    case TRACE_START:
+        fprintf(fp, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"B\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d,"
+                    "\"args\":{\"obj\":\"%p\",\"id\":%llu}}",
+                event->name, event->name, ts, pid, (int)buffer->tid, event->obj, (unsigned long long)event->id);
+        break;
+    case TRACE_FINISH:
+        fprintf(fp, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"E\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d}",
+                event->name, event->name, ts, pid, (int)buffer->tid);
+        break;
+    default:
+        break;
+    }
+}
+
+static inline int trace_dump_chrome(const char *path)
+{
+    FILE *fp = fopen(path, "w");
+    if (!fp)
+    {
+        return -1;
+    }
+
+    int pid = (int)getpid();
+    int count = 0;
+    trace_event_t *events = new (std::nothrow) trace_event_t[TRACE_BUFFER_EVENTS];
+    if (!events)
+    {
+        fclose(fp);
+        return -1;
+    }
+
+    fprintf(fp, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+                "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"pid %d\"}}", pid, pid);
+
+    trace_state_t &state = trace_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    for (trace_buffer_t *buffer = state.buffers; buffer; buffer = buffer->next)
+    {
+        fprintf(fp, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                pid, (int)buffer->tid, buffer->thread_name);
+
+        // 先拷贝再检查写位置：拷贝期间可能被写线程覆盖的事件 (距新写位置不足一圈) 丢弃
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        uint64_t begin = head > TRACE_BUFFER_EVENTS ? head - TRACE_BUFFER_EVENTS : 0;
+        for (uint64_t i = begin; i < head; ++i)
+        {
+            events[i - begin] = buffer->events[i & (TRACE_BUFFER_EVENTS - 1)];
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t after = buffer->head.load(std::memory_order_relaxed);
+        uint64_t valid = after >= TRACE_BUFFER_EVENTS ? after - TRACE_BUFFER_EVENTS + 1 : 0;
+
+        for (uint64_t i = valid > begin ? valid : begin; i < head; ++i)
+        {
+            trace_write_event(fp, pid, buffer, &events[i - begin]);
+            ++count;
+        }
+    }
+
+    fprintf(fp, "\n]}\n");
+    fclose(fp);
+    delete[] events;
+    return count;
+}
+
+#endif /* __TRACE_H__ */